@@ -0,0 +1,68 @@
+#!/bin/bash
+# Compares the navigation through the foils with and without the thin
+# envelopes around them, and for a few smartless values. For each setting
+# the navigation benchmark (/AEgIS/geometry/benchmark) is run, then a run
+# of N events with the same seed. The envelopes change the steps and thus
+# the use of the random numbers, so the events are not the same: only the
+# distributions agree, and each event count is compared with the first
+# setting by its pull (difference over its binomial error), |pull| > 3 is
+# flagged. The times are what should change.
+# Usage: benchmark/navigation.sh [buildDir] [N] [nRays]
+BUILDDIR=$(cd ${1:-build} && pwd)
+N=${2:-1000}
+NRAYS=${3:-1000}
+
+if [ ! -x $BUILDDIR/exampleB2b_batch ]
+then
+    echo "Error: build exampleB2b_batch in $BUILDDIR first"
+    exit 1
+fi
+
+WORKDIR=$(mktemp -d)
+cp $BUILDDIR/bfield.csv $WORKDIR
+cd $WORKDIR
+
+# pulls of the event counts of log.txt with respect to reference.txt
+compare_counts() {
+    for kind in Normal Killed Annihilation
+    do
+	ref=$(grep "^$kind events:" reference.txt | cut -d: -f2)
+	new=$(grep "^$kind events:" log.txt | cut -d: -f2)
+	awk -v kind=$kind -v r=$ref -v c=$new -v n=$N 'BEGIN {
+	    p = (r + c)/(2*n)
+	    sigma = sqrt(2*n*p*(1 - p))
+	    pull = sigma > 0 ? (c - r)/sigma : 0
+	    printf "  %s events: %g - %g = %g, pull %.2f%s\n", kind, c, r, c - r, pull,
+	           (pull > 3 || pull < -3) ? "  <-- differs" : ""
+	}'
+    done
+}
+
+for envelopes in false true
+do
+    for smartless in 2 4 8
+    do
+	cat > navigation.mac <<EOM
+/AEgIS/geometry/envelopes $envelopes
+/AEgIS/geometry/smartless $smartless
+/run/initialize
+/AEgIS/geometry/benchmark $NRAYS
+EOM
+	echo "envelopes $envelopes, smartless $smartless:"
+	start=$(date +%s.%N)
+	$BUILDDIR/exampleB2b_batch navigation.mac --threads 1 --seed 1 --events $N --output navigation > log.txt 2>&1
+	stop=$(date +%s.%N)
+	grep -E "^  foil|Event steps" log.txt
+	if [ -f reference.txt ]
+	then
+	    compare_counts
+	else
+	    grep "events:" log.txt
+	    cp log.txt reference.txt
+	fi
+	echo "  wall time $(echo "$stop - $start" | bc) s"
+    done
+done
+
+cd - > /dev/null
+rm -rf $WORKDIR
@@ -0,0 +1,38 @@
+#!/bin/bash
+# Compares the startup time and memory of exampleB2b and exampleB2b_batch.
+# Each binary is started N times with a run of zero events, so only the
+# construction, geometry and physics initialisation are measured. Both
+# skip the vis manager in batch, the difference is the loading of the
+# UI/vis libraries.
+# Usage: benchmark/startup_time.sh [buildDir] [N]
+BUILDDIR=$(cd ${1:-build} && pwd)
+N=${2:-10}
+
+if [ ! -x $BUILDDIR/exampleB2b ] || [ ! -x $BUILDDIR/exampleB2b_batch ]
+then
+    echo "Error: build exampleB2b and exampleB2b_batch in $BUILDDIR first"
+    exit 1
+fi
+
+WORKDIR=$(mktemp -d)
+cp $BUILDDIR/bfield.csv $WORKDIR
+cd $WORKDIR
+
+for binary in exampleB2b exampleB2b_batch
+do
+    total=0
+    maxRSS=0
+    for i in $(seq $N)
+    do
+	start=$(date +%s.%N)
+	/usr/bin/time -f "%M" -o rss.txt $BUILDDIR/$binary --threads 1 --events 0 --output startup > /dev/null 2>&1
+	stop=$(date +%s.%N)
+	total=$(echo "$total + $stop - $start" | bc)
+	rss=$(tail -1 rss.txt)
+	if [ $rss -gt $maxRSS ]; then maxRSS=$rss; fi
+    done
+    echo "$binary: mean startup $(echo "scale=3; $total / $N" | bc) s, max RSS $maxRSS kB ($N runs)"
+done
+
+cd - > /dev/null
+rm -rf $WORKDIR
@@ -1,5 +1,10 @@
 #!/bin/sh
-# Gets 5 arguments: first material, thickness, second material, thickness, BField on/off
+# Gets 5 arguments: first material, thickness, second material, thickness, BField on/off/paired
+# (paired: the same beam with the field on then off in one job, written to paired/)
+# If BEAMFILE is set, the antiprotons start from this phase-space file
+# (recorded once upstream of the foils with /AEgIS/record/file)
+# SEED and JOBID (default 1 and 0) seed the events of the job reproducibly
+# TABLECACHE (default $OUTPUTDIR/physics_tables) keeps the physics tables between jobs
 if [ $# -lt 5 ]
 then
     # if there are only 3 arguments: second material, thickness, BField on/off
@@ -32,9 +37,13 @@ echo "BField="$BFieldFlag
 GITPATH="/afs/cern.ch/user/j/jzielins/AEgIS/degraderMC" # path to the G4 conde for the analysis
 OUTPUTDIR="/eos/user/j/jzielins/G4degraderMC" # path to copy output files in the end
 FILENAME=$secondThickness${secondMaterial#G4_} # name used for all files generated from the simulation
+EVENTS=1000000
 if [ $BFieldFlag = "on" ]
 then
     OUTPUTDIR=$OUTPUTDIR/withBField
+elif [ $BFieldFlag = "paired" ]
+then
+    OUTPUTDIR=$OUTPUTDIR/paired
 else
     OUTPUTDIR=$OUTPUTDIR/withoutBField
 fi
@@ -45,50 +54,41 @@ then
     FILENAME=$firstThickness${firstMaterial#G4_}+$FILENAME
 fi
 
-# move to the output directory and create a temporary directory to be used as the work directory
-TEMPDIR=$FILENAME"-tmp"
-WORKDIR=$OUTPUTDIR/$TEMPDIR
-mkdir $WORKDIR
+# work in the local scratch of the node, the simulation moves the output file to $OUTPUTDIR itself
+WORKDIR=${_CONDOR_SCRATCH_DIR:-${TMPDIR:-/tmp}}/$FILENAME"-tmp"
+mkdir -p $WORKDIR
 cd $WORKDIR
 pwd
 
-# create config file for the simulation
-cat << EOF > $FILENAME.in
-# Macro file for the initialization of example B2 
-# in interactive session
-#
-# Set some default verbose
-/control/verbose 2
-/control/saveHistory
-/run/verbose 0
-#
-# Change the default number of threads (in multi-threaded mode)
-/run/numberOfThreads 1
-#
-# Foil geometry
-# G4_NAPHTHALENE
-/AEgIS/degrader/setFirstMaterial $firstMaterial
-/AEgIS/degrader/setFirstThickness $firstThickness nm
-
-/AEgIS/degrader/setSecondMaterial $secondMaterial
-/AEgIS/degrader/setSecondThickness $secondThickness nm
+# options of the simulation, a macro is only needed for the phase-space beam
+# (one thread per CPU of the slot: THREADS is request_cpus in the .sub file,
+# HTCondor limits the CPU time with cgroups, the affinity shows all cores)
+THREADS=${THREADS:-${OMP_NUM_THREADS:-$(nproc)}}
+OPTIONS="--no-vis --grain 100 --threads $THREADS
+ --material1 $firstMaterial --thickness1 $firstThickness
+ --material2 $secondMaterial --thickness2 $secondThickness
+ --seed ${SEED:-1} --job ${JOBID:-0}"
+if [ $BFieldFlag = "paired" ]
+then
+    # the runs are started by the macro, one file per field state
+    OPTIONS="$OPTIONS --output $OUTPUTDIR/${FILENAME}_field%field%"
+    OUTPUTFILE=$OUTPUTDIR/${FILENAME}_fieldon.root
+else
+    OPTIONS="$OPTIONS --field $BFieldFlag --output $OUTPUTDIR/$FILENAME --events $EVENTS"
+    OUTPUTFILE=$OUTPUTDIR/$FILENAME.root
+fi
 
-/AEgIS/BField $BFieldFlag
-#
-# Initialize kernel
+# output written in the local work directory and moved to EOS at the end of run
+cat << EOF > $FILENAME.in
+/AEgIS/output/scratchDir $WORKDIR
+/AEgIS/physics/tableCache ${TABLECACHE:-/eos/user/j/jzielins/G4degraderMC/physics_tables}
 /run/initialize
-#
-/gun/particle anti_proton
-/gun/energy 100 keV
-/tracking/verbose 0
-
-/run/beamOn 1000000
+${BEAMFILE:+/AEgIS/beam/file $BEAMFILE}
+${BEAMFILE:+/AEgIS/beam/mode file}
 EOF
-
-if [ ! -f $FILENAME.in ]
+if [ $BFieldFlag = "paired" ]
 then
-    echo "Error: config file was not created"
-    exit 1
+    echo "/AEgIS/run/pairedBeamOn $EVENTS" >> $FILENAME.in
 fi
 
 # Set up compilers and environments
@@ -101,18 +101,19 @@ cp $GITPATH/src/bfield.csv $WORKDIR
 echo
 echo "Start time: $(date)"
 
-$GITPATH/build/exampleB2b $FILENAME.in
+$GITPATH/build/exampleB2b_batch $OPTIONS $FILENAME.in
 
 echo "Stop time: $(date)"
 echo
 
-if [ -f "man_output.root" ]
+if [ -f "$OUTPUTFILE" ]
 then
-    mv man_output.root $OUTPUTDIR/$FILENAME.root
+    echo $OPTIONS > $OUTPUTDIR/configs/$FILENAME.args
     mv $FILENAME.in $OUTPUTDIR/configs/
 else
-    echo "Error: output file (man_output.root) doesn't exist"
+    echo "Error: output file ($OUTPUTFILE) doesn't exist"
     exit 1
 fi
 
-# rm -rf $WORKDIR
+cd ..
+rm -rf $WORKDIR
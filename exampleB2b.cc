@@ -29,33 +29,186 @@
 
 #include "B2bDetectorConstruction.hh"
 #include "B2ActionInitialization.hh"
+#include "B2AntiprotonPhysicsList.hh"
+#include "B2PhysicsTableCache.hh"
 
-#ifdef G4MULTITHREADED
-#include "G4MTRunManager.hh"
-#else
-#include "G4RunManager.hh"
-#endif
+#include "G4RunManagerFactory.hh"
+#include "G4Threading.hh"
 
 #include "G4UImanager.hh"
+#include "G4StateManager.hh"
 #include "FTFP_BERT.hh"
 #include "G4StepLimiterPhysics.hh"
 
 #include "Randomize.hh"
 // #include "G4Random.hh"
 
+// exampleB2b_batch is built with B2_BATCH_ONLY and links no UI/vis drivers
+#ifndef B2_BATCH_ONLY
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
+#endif
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  void PrintUsage()
+  {
+    G4cout << "Usage: exampleB2b [options] [macro [masterSeed [jobID]]]\n"
+           << "Without macro and --events an interactive session is started.\n"
+           << "The options are applied as UI commands before the macro:\n"
+           << "  --threads N        /run/numberOfThreads N (default: OMP_NUM_THREADS,\n"
+           << "                     set by batch systems to the CPUs of the slot, or\n"
+           << "                     else the CPUs the process may run on)\n"
+           << "  --run-manager TYPE serial, mt or tasking (default: tasking)\n"
+           << "  --grain N          /run/eventModulo N, events per task\n"
+           << "  --events N         /run/beamOn N after the macro\n"
+           << "  --seed N           /AEgIS/random/seed N\n"
+           << "  --job N            /AEgIS/random/jobID N\n"
+           << "  --material1 NAME   /AEgIS/degrader/setFirstMaterial NAME\n"
+           << "  --thickness1 T     /AEgIS/degrader/setFirstThickness T nm\n"
+           << "  --material2 NAME   /AEgIS/degrader/setSecondMaterial NAME\n"
+           << "  --thickness2 T     /AEgIS/degrader/setSecondThickness T nm\n"
+           << "  --field on|off     /AEgIS/BField on|off\n"
+           << "  --output NAME      /AEgIS/output/file NAME\n"
+           << "  --checkpoint FILE  /AEgIS/checkpoint/file FILE, --events then runs\n"
+           << "                     in chunks (/AEgIS/checkpoint/beamOn)\n"
+           << "  --checkpoint-events N  /AEgIS/checkpoint/events N\n"
+           << "  --resume           continue from the checkpoint file\n"
+           << "  --physics NAME     ftfp_bert (default) or antiproton, the lean\n"
+           << "                     list of B2AntiprotonPhysicsList\n"
+           << "  --no-vis           do not create the vis manager\n"
+           << "  -h, --help         print this help" << G4endl;
+  }
+
+  // CPUs of the job: a batch system limiting the CPU time with cgroups
+  // (HTCondor) leaves the affinity to all cores of the node but exports
+  // OMP_NUM_THREADS, the affinity is the fallback for interactive runs
+  G4int AvailableCores()
+  {
+    const char* ompThreads = std::getenv("OMP_NUM_THREADS");
+    if ( ompThreads && std::atoi(ompThreads) > 0 ) return std::atoi(ompThreads);
+#ifdef __linux__
+    cpu_set_t cpus;
+    if ( sched_getaffinity(0, sizeof(cpus), &cpus) == 0 ) return CPU_COUNT(&cpus);
+#endif
+    return G4Threading::G4GetNumberOfCores();
+  }
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 int main(int argc,char** argv)
 {
-  // Detect interactive mode (if no arguments) and define UI session
+  // Parse the command line: options become UI commands, the remaining
+  // arguments are the macro and the optional seed and job ID
   //
+  std::vector<G4String> commands;
+  std::vector<G4String> positional;
+  G4String nofEvents;
+  G4bool noVis = false;
+  G4bool threadsSet = false;
+  G4bool checkpoint = false;
+  G4String physicsName = "ftfp_bert";
+  G4RunManagerType runManagerType = G4RunManagerType::Default;
+  // value options and the UI command they are translated to
+  const std::map<G4String,G4String> optionCommands = {
+    {"--threads",    "/run/numberOfThreads "},
+    {"--grain",      "/run/eventModulo "},
+    {"--seed",       "/AEgIS/random/seed "},
+    {"--job",        "/AEgIS/random/jobID "},
+    {"--material1",  "/AEgIS/degrader/setFirstMaterial "},
+    {"--material2",  "/AEgIS/degrader/setSecondMaterial "},
+    {"--field",      "/AEgIS/BField "},
+    {"--output",     "/AEgIS/output/file "},
+    {"--checkpoint",  "/AEgIS/checkpoint/file "},
+    {"--checkpoint-events", "/AEgIS/checkpoint/events "}
+  };
+  for ( G4int i = 1; i < argc; i++ ) {
+    G4String arg = argv[i];
+    if ( arg == "-h" || arg == "--help" ) {
+      PrintUsage();
+      return 0;
+    }
+    if ( arg == "--no-vis" ) {
+      noVis = true;
+      continue;
+    }
+    if ( arg == "--resume" ) {
+      commands.push_back("/AEgIS/checkpoint/resume true");
+      continue;
+    }
+    if ( !G4StrUtil::starts_with(arg, "--") ) {
+      positional.push_back(arg);
+      continue;
+    }
+    if ( i+1 >= argc ) {
+      G4cerr << "Missing value for " << arg << G4endl;
+      PrintUsage();
+      return 1;
+    }
+    G4String value = argv[++i];
+    auto option = optionCommands.find(arg);
+    if ( arg == "--threads" ) threadsSet = true;
+    if ( arg == "--checkpoint" ) checkpoint = true;
+    if ( option != optionCommands.end() ) commands.push_back(option->second + value);
+    else if ( arg == "--thickness1" ) commands.push_back("/AEgIS/degrader/setFirstThickness " + value + " nm");
+    else if ( arg == "--thickness2" ) commands.push_back("/AEgIS/degrader/setSecondThickness " + value + " nm");
+    else if ( arg == "--events" ) nofEvents = value;
+    else if ( arg == "--physics" ) {
+      if ( value != "ftfp_bert" && value != "antiproton" ) {
+        G4cerr << "Unknown physics list " << value << G4endl;
+        PrintUsage();
+        return 1;
+      }
+      physicsName = value;
+    }
+    else if ( arg == "--run-manager" ) {
+      if ( value == "serial" ) runManagerType = G4RunManagerType::SerialOnly;
+      else if ( value == "mt" ) runManagerType = G4RunManagerType::MTOnly;
+      else if ( value == "tasking" ) runManagerType = G4RunManagerType::TaskingOnly;
+      else {
+        G4cerr << "Unknown run manager " << value << G4endl;
+        PrintUsage();
+        return 1;
+      }
+    }
+    else {
+      G4cerr << "Unknown option " << arg << G4endl;
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  // exampleB2b macro [masterSeed [jobID]] seeds every event from the
+  // master seed (same as --seed and --job)
+  if ( positional.size() > 1 ) commands.push_back("/AEgIS/random/seed " + positional[1]);
+  if ( positional.size() > 2 ) commands.push_back("/AEgIS/random/jobID " + positional[2]);
+
+  // Detect interactive mode (no macro and no events) and define UI session
+  //
+  G4bool batch = !positional.empty() || !nofEvents.empty();
+#ifdef B2_BATCH_ONLY
+  if ( ! batch ) {
+    G4cerr << "exampleB2b_batch needs a macro or --events" << G4endl;
+    PrintUsage();
+    return 1;
+  }
+  (void)noVis;
+#else
   G4UIExecutive* ui = 0;
-  if ( argc == 1 ) {
+  if ( ! batch ) {
     ui = new G4UIExecutive(argc, argv);
   }
+#endif
 
   // G4long seed = time(NULL);
   // G4Random::setTheSeed(seed);
@@ -63,59 +216,89 @@ int main(int argc,char** argv)
   // Optionally: choose a different Random engine...
   // G4Random::setTheEngine(new CLHEP::MTwistEngine);
   
-  // Construct the default run manager
+  // Construct the run manager, the task based one by default: the events
+  // are handed out in small tasks, so a long event does not hold back a
+  // whole block of events assigned to its thread
   //
-#ifdef G4MULTITHREADED
-  G4MTRunManager* runManager = new G4MTRunManager;
-#else
-  G4RunManager* runManager = new G4RunManager;
-#endif
+  auto runManager = G4RunManagerFactory::CreateRunManager(runManagerType);
+  if ( ! threadsSet && ! std::getenv("G4_FORCENUMBEROFTHREADS") ) {
+    runManager->SetNumberOfThreads(AvailableCores());
+  }
 
   // Set mandatory initialization classes
   //
   runManager->SetUserInitialization(new B2bDetectorConstruction());
 
-  G4VModularPhysicsList* physicsList = new FTFP_BERT;
-  physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+  G4VModularPhysicsList* physicsList = 0;
+  if ( physicsName == "antiproton" ) {
+    physicsList = new B2AntiprotonPhysicsList;
+  }
+  else {
+    physicsList = new FTFP_BERT;
+    physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+  }
   runManager->SetUserInitialization(physicsList);
+  // the list name is part of the key of /AEgIS/physics/tableCache
+  B2PhysicsTableCache::SetPhysicsList(physicsList, physicsName);
     
   // Set user action classes
   runManager->SetUserInitialization(new B2ActionInitialization());
   
-  // Initialize visualization
+  // Initialize visualization, only needed in interactive sessions
   //
-  G4VisManager* visManager = new G4VisExecutive;
-  // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
-  // G4VisManager* visManager = new G4VisExecutive("Quiet");
-  visManager->Initialize();
+#ifndef B2_BATCH_ONLY
+  G4VisManager* visManager = 0;
+  if ( ! batch && ! noVis ) {
+    visManager = new G4VisExecutive;
+    // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
+    // G4VisManager* visManager = new G4VisExecutive("Quiet");
+    visManager->Initialize();
+  }
+#endif
 
   // Get the pointer to the User Interface manager
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
 
+  // Command line options, applied before the macro so it can override them
+  for ( const auto& command : commands ) UImanager->ApplyCommand(command);
+
   // Process macro or start UI session
   //
-  if ( ! ui ) {
+  if ( batch ) {
     // barch mode
-    G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
+    if ( ! positional.empty() ) {
+      G4String command = "/control/execute ";
+      G4String fileName = positional[0];
+      UImanager->ApplyCommand(command+fileName);
+    }
+    if ( ! nofEvents.empty() ) {
+      if ( G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit ) {
+        UImanager->ApplyCommand("/run/initialize");
+      }
+      if ( checkpoint ) UImanager->ApplyCommand("/AEgIS/checkpoint/beamOn " + nofEvents);
+      else UImanager->ApplyCommand("/run/beamOn " + nofEvents);
+    }
   }
+#ifndef B2_BATCH_ONLY
   else {  
     // interactive mode
-    UImanager->ApplyCommand("/control/execute init_vis.mac");
+    if ( visManager ) UImanager->ApplyCommand("/control/execute init_vis.mac");
     if (ui->IsGUI()) {
       UImanager->ApplyCommand("/control/execute gui.mac");
     }
     ui->SessionStart();
     delete ui;
   }
+#endif
 
   // Job termination
   // Free the store: user actions, physics_list and detector_description are
   // owned and deleted by the run manager, so they should not be deleted
   // in the main() program !
 
+#ifndef B2_BATCH_ONLY
   delete visManager;
+#endif
   delete runManager;
 }
 
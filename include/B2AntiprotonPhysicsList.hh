@@ -0,0 +1,57 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2AntiprotonPhysicsList.hh
+/// \brief Definition of the B2AntiprotonPhysicsList class
+
+#ifndef B2AntiprotonPhysicsList_h
+#define B2AntiprotonPhysicsList_h 1
+
+#include "G4VModularPhysicsList.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Physics list with only what the slowing down of antiprotons in the
+/// degrader foils needs (selected with --physics antiproton):
+/// - low-energy EM physics (G4EmStandardPhysics_option4): energy loss
+///   and multiple scattering
+/// - G4StoppingPhysics: capture and annihilation at rest
+/// - G4DecayPhysics for the annihilation products
+/// - G4StepLimiterPhysics for the step limits of the foils
+/// No hadronic physics in flight is built, so no hadronic data is loaded.
+
+class B2AntiprotonPhysicsList: public G4VModularPhysicsList
+{
+public:
+  B2AntiprotonPhysicsList(G4int verbose = 0);
+  virtual ~B2AntiprotonPhysicsList();
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
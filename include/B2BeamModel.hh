@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2BeamModel.hh
+/// \brief Definition of the B2BeamModel class
+
+#ifndef B2BeamModel_h
+#define B2BeamModel_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Parametric antiproton beam for /AEgIS/beam/mode twiss.
+///
+/// The transverse phase space in x and y is a Gaussian given by the
+/// Twiss parameters alpha, beta and the rms geometric emittance at the
+/// gun plane:
+///   x  = sqrt(eps*beta) u1
+///   x' = sqrt(eps/beta) (-alpha u1 + u2)
+/// with u1, u2 standard normal numbers. An extra uncorrelated divergence
+/// can be added. The kinetic energy is spread around /gun/energy and the
+/// start time around 0, both either Gaussian (rms) or uniform (half width).
+///
+/// The random numbers are generated in batches with shootArray and used
+/// event by event, instead of one engine call per coordinate.
+
+class B2BeamModel
+{
+  public:
+    enum Shape { kGaussian, kUniform };
+
+    B2BeamModel();
+    ~B2BeamModel();
+
+    // position on the gun plane (z = 0), direction and kinetic energy
+    void Sample(G4double meanEnergy, G4ThreeVector& position,
+                G4ThreeVector& direction, G4double& energy, G4double& time);
+
+    // drop the buffered random numbers, e.g. after the engine was reseeded
+    void ClearBuffers();
+
+    // Set methods
+    void SetTwissX(G4double alpha, G4double beta, G4double emittance);
+    void SetTwissY(G4double alpha, G4double beta, G4double emittance);
+    void SetDivergence(G4double divergence) { fDivergence = divergence; }
+    void SetEnergySpread(G4double spread, Shape shape) { fEnergySpread = spread; fEnergyShape = shape; }
+    void SetTimeSpread(G4double spread, Shape shape) { fTimeSpread = spread; fTimeShape = shape; }
+
+  private:
+    G4double NextGauss();
+    G4double NextFlat(); // in [-1, 1)
+    G4double Spread(G4double width, Shape shape);
+
+    static const G4int fBatchSize = 1024;
+
+    G4double fAlphaX, fBetaX, fEmittanceX;
+    G4double fAlphaY, fBetaY, fEmittanceY;
+    G4double fDivergence;   // extra rms angle in x and y
+    G4double fEnergySpread;
+    Shape    fEnergyShape;
+    G4double fTimeSpread;
+    Shape    fTimeShape;
+
+    std::vector<G4double> fGauss;
+    std::vector<G4double> fFlat;
+    std::size_t           fNextGauss;
+    std::size_t           fNextFlat;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
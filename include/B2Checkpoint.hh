@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2Checkpoint.hh
+/// \brief Definition of the B2Checkpoint class
+
+#ifndef B2Checkpoint_h
+#define B2Checkpoint_h 1
+
+#include "globals.hh"
+
+#include <array>
+#include <vector>
+
+struct B2TrapWindow;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// State of a run split in chunks by /AEgIS/checkpoint/beamOn.
+///
+/// Each chunk is a complete Geant4 run with its own output file. After each
+/// chunk the master adds the merged tallies and writes this state to the
+/// checkpoint file, so a preempted job can continue from the last finished
+/// chunk (/AEgIS/checkpoint/resume). The file is plain text and is replaced
+/// atomically. The events of chunk i are seeded with the run ID
+/// kSeedRunIDs + first + i, where first is chosen when the checkpointed run
+/// starts and stored in the file: the streams are the same after a restart,
+/// and differ from those of the normal runs and of other checkpointed runs.
+
+class B2Checkpoint
+{
+  public:
+    B2Checkpoint();
+
+    // seed run IDs of the chunks, above all Geant4 run IDs
+    static const G4int kSeedRunIDs = 1 << 30;
+
+    void Reset(G4long totalEvents, G4int chunkEvents);
+    G4bool Read(const G4String& fileName);
+    void Write(const G4String& fileName) const;
+
+    void AddChunk(G4int nofEvents, G4double annihilations, G4double normal, G4double killed,
+                  const std::vector<B2TrapWindow*>& windows, const G4String& outputFile);
+    void Print() const;
+
+    G4long GetTotalEvents() const { return fTotalEvents; }
+    G4int  GetChunkEvents() const { return fChunkEvents; }
+    G4int  GetChunksDone() const { return fChunksDone; }
+    G4long GetEventsDone() const { return fEventsDone; }
+    G4long GetMasterSeed() const { return fMasterSeed; }
+    G4long GetJobID() const { return fJobID; }
+    // -1 until the first chunk starts
+    G4int  GetFirstRunID() const { return fFirstRunID; }
+    void   SetFirstRunID(G4int runID) { fFirstRunID = runID; }
+    G4int  GetSeedRunID() const { return kSeedRunIDs + fFirstRunID + fChunksDone; }
+
+  private:
+    G4long fTotalEvents;
+    G4int  fChunkEvents;
+    G4int  fChunksDone;
+    G4long fEventsDone;
+    G4long fMasterSeed; // -1 when the events are not seeded by B2RandomSeeder
+    G4long fJobID;
+    G4int  fFirstRunID;
+    G4double fAnnihilations; // weighted numbers of events
+    G4double fNormal;
+    G4double fKilled;
+    // maxPz, maxPt, sumW, sumW2 of each trap window
+    std::vector<std::array<G4double,4>> fWindows;
+    std::vector<G4String> fFiles; // output file of each chunk
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2EnergyLossTable.hh
+/// \brief Definition of the B2EnergyLossTable class
+
+#ifndef B2EnergyLossTable_h
+#define B2EnergyLossTable_h 1
+
+#include "globals.hh"
+#include "G4Material.hh"
+#include "G4Log.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <vector>
+
+class G4ParticleDefinition;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Dense stopping power and CSDA range tables of one particle.
+///
+/// The tables are computed once per thread with G4EmCalculator for all
+/// the materials of the material table, on a log-energy grid covering the
+/// antiprotons leaving the degrader (by default 100 eV - 200 keV, 50 bins
+/// per decade), and are interpolated linearly in log(E) without branches.
+/// They serve cheap per-step range estimates (/AEgIS/physics/rangeKill);
+/// the energy loss of the tracking itself is left to the EM processes.
+/// /AEgIS/physics/printStoppingPower compares them with G4EmCalculator.
+
+class B2EnergyLossTable
+{
+  public:
+    // table of the calling thread
+    static B2EnergyLossTable* Instance();
+
+    void Build(const G4ParticleDefinition* particle,
+               G4double minEnergy = 100*CLHEP::eV, G4double maxEnergy = 200*CLHEP::keV,
+               G4int binsPerDecade = 50);
+    // built for the current material table
+    G4bool IsValid() const
+      { return fNofMaterials > 0 && fNofMaterials == G4Material::GetNumberOfMaterials(); }
+
+    G4double GetMinEnergy() const { return fMinEnergy; }
+    G4double GetMaxEnergy() const { return fMaxEnergy; }
+
+    // clamped to the table limits: above the maximum energy the values
+    // of the maximum energy are returned
+    G4double GetDEDX(const G4Material* material, G4double energy) const
+      { return Interpolate(fDEDX, material, energy); }
+    G4double GetRange(const G4Material* material, G4double energy) const
+      { return Interpolate(fRange, material, energy); }
+
+    // print the tables against G4EmCalculator for all the materials
+    void Validate() const;
+
+  private:
+    B2EnergyLossTable();
+
+    G4double Interpolate(const std::vector<G4double>& table,
+                         const G4Material* material, G4double energy) const
+    {
+      G4double x = (G4Log(energy) - fLogMinEnergy)*fInvLogStep;
+      x = std::min(std::max(x, 0.), G4double(fNofBins - 1));
+      G4int i = std::min(G4int(x), fNofBins - 2);
+      const G4double* value = &table[material->GetIndex()*fNofBins + i];
+      return value[0] + (x - i)*(value[1] - value[0]);
+    }
+
+    const G4ParticleDefinition* fParticle;
+    std::size_t fNofMaterials;
+    G4int fNofBins;
+    G4double fMinEnergy;
+    G4double fMaxEnergy;
+    G4double fLogMinEnergy;
+    G4double fInvLogStep;
+    std::vector<G4double> fDEDX;  // [material][bin]
+    std::vector<G4double> fRange; // [material][bin]
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -35,6 +35,9 @@
 
 #include "globals.hh"
 
+#include <chrono>
+#include <vector>
+
 // class B2RunAction;
 
 /// Event action class
@@ -47,13 +50,21 @@ class B2EventAction : public G4UserEventAction
 
     virtual void  BeginOfEventAction(const G4Event* );
     virtual void    EndOfEventAction(const G4Event* );
-    virtual void IsKilledEvent(){fKilledEvent=true;}
-    virtual void IsAnnihilationEvent(){fAnnihilationEvent=true;}
+    // weight of a track ending killed or annihilated, so that an event
+    // whose primary was split counts for each copy with its weight
+    virtual void AddKilledTrack(G4double weight){fKilledWeight+=weight;}
+    virtual void AddAnnihilatedTrack(G4double weight){fAnnihilatedWeight+=weight;}
+    void AddDetectedAntiproton(G4double pz, G4double pt, G4double weight = 1.);
+    B2RunAction* GetRunAction() const { return fRunAction; }
+    void AddStep() { fStepCount++; }
 
   private:
     B2RunAction* fRunAction;
-    G4bool fKilledEvent;
-    G4bool fAnnihilationEvent;
+    G4double fKilledWeight;
+    G4double fAnnihilatedWeight;
+    std::vector<G4double> fTrapWindowCounts; // weighted trappable antiprotons in this event
+    G4long fStepCount; // steps of all tracks in this event
+    std::chrono::steady_clock::time_point fEventStart;
 
 };
 
@@ -0,0 +1,83 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2HitBuffer.hh
+/// \brief Definition of the B2HitRecord struct and B2HitBuffer class
+
+#ifndef B2HitBuffer_h
+#define B2HitBuffer_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Fixed-size record of an antiproton reaching the detector, position
+/// in mm, momentum (Ekin x direction) and kinetic energy in keV and weight.
+
+struct B2HitRecord
+{
+  G4int    eventID;
+  G4int    threadID;
+  G4double x, y, z;
+  G4double px, py, pz;
+  G4double kineticEnergy;
+  G4double weight;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Lock-free single-producer/single-consumer ring buffer of hit records.
+///
+/// Each worker thread owns one buffer and is its only producer, the
+/// B2OutputWriter thread is the only consumer. The capacity is rounded
+/// up to a power of two.
+
+class B2HitBuffer
+{
+  public:
+    explicit B2HitBuffer(std::size_t capacity);
+    ~B2HitBuffer();
+
+    // producer side, returns false if the buffer is full
+    G4bool Push(const B2HitRecord& record);
+    // consumer side, returns false if the buffer is empty
+    G4bool Pop(B2HitRecord& record);
+
+  private:
+    std::vector<B2HitRecord> fRecords;
+    std::size_t              fMask;
+    std::atomic<std::size_t> fHead; // next slot written by the producer
+    std::atomic<std::size_t> fTail; // next slot read by the consumer
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
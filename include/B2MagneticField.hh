@@ -33,6 +33,8 @@
 #include "globals.hh"
 #include "G4MagneticField.hh"
 
+#include <vector>
+
 class G4GenericMessenger;
 
 /// Magnetic field
@@ -49,12 +51,15 @@ class B2MagneticField : public G4MagneticField
     G4GenericMessenger* fMessenger;
     G4double fMagneticFieldStart; // first Z value with the magnetic field
 
+    static void ReadFieldMap();
+
 //    G4double rB[6], zB[6], bR[6], bZ[6];
-    G4double aegisrB[65592];
-    G4double aegiszB[65592];
-    G4double aegisbR[65592];
-    G4double aegisbZ[65592];
-    G4int    aegisbGranularity;
+    // the map is read once and shared read-only by the fields of all threads
+    static std::vector<G4double> aegisrB;
+    static std::vector<G4double> aegiszB;
+    static std::vector<G4double> aegisbR;
+    static std::vector<G4double> aegisbZ;
+    static G4int    aegisbGranularity;
 
 };
 
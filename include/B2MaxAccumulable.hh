@@ -0,0 +1,64 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2MaxAccumulable.hh
+/// \brief Definition of the B2MaxAccumulable class
+
+#ifndef B2MaxAccumulable_h
+#define B2MaxAccumulable_h 1
+
+#include "globals.hh"
+#include "G4VAccumulable.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Accumulable keeping the largest value of all the threads.
+///
+/// G4MergeMode of Geant4 11.1 only adds or multiplies, the maximum of the
+/// run (slowest event, longest event) is merged here with std::max.
+
+class B2MaxAccumulable : public G4VAccumulable
+{
+  public:
+    B2MaxAccumulable(const G4String& name = "") : G4VAccumulable(name), fValue(0.) {}
+
+    virtual void Merge(const G4VAccumulable& other)
+      { fValue = std::max(fValue, static_cast<const B2MaxAccumulable&>(other).fValue); }
+    virtual void Reset() { fValue = 0.; }
+
+    void Update(G4double value) { fValue = std::max(fValue, value); }
+    G4double GetValue() const { return fValue; }
+
+  private:
+    G4double fValue;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
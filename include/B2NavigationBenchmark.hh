@@ -0,0 +1,64 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2NavigationBenchmark.hh
+/// \brief Definition of the B2NavigationBenchmark class
+
+#ifndef B2NavigationBenchmark_h
+#define B2NavigationBenchmark_h 1
+
+#include "globals.hh"
+
+#include <utility>
+#include <vector>
+
+class G4VPhysicalVolume;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Times the navigation through the foils (/AEgIS/geometry/benchmark).
+///
+/// Straight rays are stepped through each foil, from 10 um before to
+/// 10 um after it, with steps of at most maxStep, the same calls to a
+/// G4Navigator as the transportation makes. The rays are spread over the
+/// foil on a fixed spiral, so the random engine is not used and the
+/// results of a following run are unchanged. Only the navigation is
+/// timed, to compare geometry options (envelopes, smartless) without
+/// the physics.
+
+class B2NavigationBenchmark
+{
+  public:
+    // foils: z range of each foil in the world
+    static void Run(G4VPhysicalVolume* world,
+                    const std::vector<std::pair<G4double,G4double> >& foils,
+                    G4int nRays, G4double maxStep);
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
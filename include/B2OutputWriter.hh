@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2OutputWriter.hh
+/// \brief Definition of the B2OutputWriter class
+
+#ifndef B2OutputWriter_h
+#define B2OutputWriter_h 1
+
+#include "globals.hh"
+#include "B2HitBuffer.hh"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Asynchronous writer of the antiproton hits (/AEgIS/output/mode stream).
+///
+/// The worker threads push B2HitRecord into their own B2HitBuffer and never
+/// wait for the file. A single writer thread drains the buffers and writes
+/// the records in column chunks:
+///   header:  "B2HITS03"
+///   chunk:   uint32 nRecords, uint32 nBytes, then nBytes of zlib data
+///            holding each column as nRecords values (eventID, threadID
+///            as int32; x, y, z [mm], px, py, pz, kineticEnergy [keV],
+///            weight as double)
+/// Columns of similar values compress well, the fastest zlib level keeps
+/// the writer ahead of the workers.
+/// The file is read back with analyse/ReadHitStream.C.
+///
+/// The writer is opened and closed by the master B2RunAction, so all
+/// workers have finished the run before the last chunk is written.
+
+class B2OutputWriter
+{
+  public:
+    static B2OutputWriter* Instance();
+    ~B2OutputWriter();
+
+    void Open(const G4String& fileName);
+    void Close();
+    G4bool IsOpen() const { return fOpen; }
+
+    // called from the worker threads
+    void Push(const B2HitRecord& record);
+
+  private:
+    B2OutputWriter();
+
+    B2HitBuffer* GetThreadBuffer();
+    void Run();
+    std::size_t Drain();
+    void WriteChunk();
+
+    static const std::size_t fBufferCapacity = 1 << 14; // records per thread
+    static const std::size_t fChunkSize = 1 << 16;      // records per chunk
+
+    std::vector<B2HitBuffer*> fBuffers;
+    std::mutex                fBuffersMutex;
+
+    std::ofstream       fFile;
+    std::thread         fThread;
+    std::atomic<G4bool> fOpen;
+    std::atomic<G4bool> fStop;
+    std::size_t         fNofRecords;
+
+    // columns of the chunk being filled
+    std::vector<G4int>    fEventID, fThreadID;
+    std::vector<G4double> fX, fY, fZ, fPx, fPy, fPz, fKineticEnergy, fWeight;
+    // uncompressed and compressed chunk, kept to reuse their memory
+    std::vector<char> fRawChunk, fZippedChunk;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
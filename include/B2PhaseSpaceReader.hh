@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PhaseSpaceReader.hh
+/// \brief Definition of the B2PhaseSpaceReader class
+
+#ifndef B2PhaseSpaceReader_h
+#define B2PhaseSpaceReader_h 1
+
+#include "globals.hh"
+
+#include <cstddef>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// One beam particle: position in mm, momentum in MeV/c, time in ns
+/// and statistical weight.
+
+struct B2PhaseSpaceRecord
+{
+  G4double x, y, z;
+  G4double px, py, pz;
+  G4double t;
+  G4double weight;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Reader of a beam phase-space file for B2PrimaryGeneratorAction.
+///
+/// Two formats are accepted:
+/// - binary (any extension but .csv): records of 8 doubles
+///   x y z px py pz t weight, native byte order, no header
+/// - csv: one record per line, same columns separated by commas or
+///   spaces, the weight column is optional; lines starting with a
+///   letter or '#' (header, comments) are skipped
+///
+/// The file is memory mapped, so it is never loaded as a whole. Every
+/// thread creates its own reader for slice i of n and reads only its
+/// part of the file, there is no shared cursor. When the slice is used
+/// up, the reader starts again from the beginning of its slice.
+
+class B2PhaseSpaceReader
+{
+  public:
+    B2PhaseSpaceReader(const G4String& fileName, G4int slice, G4int nofSlices);
+    ~B2PhaseSpaceReader();
+
+    G4bool IsOpen() const { return fData != nullptr; }
+    G4bool Next(B2PhaseSpaceRecord& record);
+
+  private:
+    G4bool ReadBinary(B2PhaseSpaceRecord& record);
+    G4bool ReadCSV(B2PhaseSpaceRecord& record);
+    const char* NextLine(const char* pos) const;
+    void Rewind();
+
+    G4String    fFileName;
+    G4bool      fBinary;
+    const char* fData;   // mapped file
+    std::size_t fSize;
+    const char* fBegin;  // slice of this thread
+    const char* fEnd;
+    const char* fCursor;
+    G4int       fSlice;
+    G4int       fNofLoops;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
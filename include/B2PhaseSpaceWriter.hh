@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PhaseSpaceWriter.hh
+/// \brief Definition of the B2PhaseSpaceWriter class
+
+#ifndef B2PhaseSpaceWriter_h
+#define B2PhaseSpaceWriter_h 1
+
+#include "globals.hh"
+#include "B2PhaseSpaceReader.hh"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Writer of the beam phase space at the /AEgIS/record/plane
+/// (first stage of a two-stage simulation).
+///
+/// The records are written in the binary format of B2PhaseSpaceReader,
+/// so the file can be used directly with /AEgIS/beam/file. Each thread
+/// collects its records in a local buffer, which is appended to the file
+/// under a lock when it is full and at the end of the run.
+
+class B2PhaseSpaceWriter
+{
+  public:
+    static B2PhaseSpaceWriter* Instance();
+    ~B2PhaseSpaceWriter();
+
+    // called by the master
+    void Open(const G4String& fileName);
+    void Close();
+    G4bool IsOpen() const { return fOpen; }
+
+    // called by the thread which tracks the particle
+    void Write(const B2PhaseSpaceRecord& record);
+    void Flush();
+
+  private:
+    B2PhaseSpaceWriter();
+
+    std::vector<B2PhaseSpaceRecord>& GetThreadBuffer();
+
+    static const std::size_t fBufferSize = 4096; // records per thread
+
+    std::ofstream       fFile;
+    std::mutex          fMutex;
+    std::atomic<G4bool> fOpen;
+    G4long              fNofRecords;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PhysicsTableCache.hh
+/// \brief Definition of the B2PhysicsTableCache class
+
+#ifndef B2PhysicsTableCache_h
+#define B2PhysicsTableCache_h 1
+
+#include "globals.hh"
+
+class G4VUserPhysicsList;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Cache of the built physics tables between runs and jobs.
+///
+/// Once a cache directory is given (/AEgIS/physics/tableCache), the
+/// tables are stored in <dir>/<key>/, where the key is a hash of the
+/// Geant4 version, the physics list, the production cuts and the
+/// material table. When the tables of the current key are already in
+/// the cache the physics list retrieves them instead of building them,
+/// otherwise the master stores them once they are built at the start of
+/// the next run. The key is recomputed whenever the materials change.
+
+class B2PhysicsTableCache
+{
+  public:
+    // physics list of the master, set in main() with the name used in the key
+    static void SetPhysicsList(G4VUserPhysicsList* physicsList, const G4String& name)
+      { fPhysicsList = physicsList; fPhysicsListName = name; }
+    static void SetDirectory(const G4String& directory);
+
+    static G4bool IsEnabled() { return !fDirectory.empty(); }
+    static G4String GetKey();
+
+    // master: retrieve the tables of the current key if cached, called
+    // whenever the material table may have changed
+    static void Prepare();
+    // master: store the tables built for this run if they were not cached
+    static void StoreIfPending();
+
+  private:
+    static G4VUserPhysicsList* fPhysicsList;
+    static G4String fPhysicsListName;
+    static G4String fDirectory;
+    static G4String fKey;
+    static G4bool   fStorePending;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -35,6 +35,9 @@
 
 class G4ParticleGun;
 class G4Event;
+class B2PhaseSpaceReader;
+class B2BeamModel;
+class B2PrimaryGeneratorMessenger;
 
 /// The primary generator action class with particle gum.
 ///
@@ -42,6 +45,10 @@ class G4Event;
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class 
 /// (see the macros provided with this example).
+///
+/// With /AEgIS/beam/mode file the antiprotons are read from a
+/// phase-space file instead (see B2PhaseSpaceReader) and with
+/// /AEgIS/beam/mode twiss from a parametric beam (see B2BeamModel).
 
 class B2PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -52,12 +59,31 @@ class B2PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     virtual void GeneratePrimaries(G4Event* );
 
     G4ParticleGun* GetParticleGun() {return fParticleGun;}
+    B2BeamModel* GetBeamModel() {return fBeamModel;}
   
     // Set methods
     void SetRandomFlag(G4bool );
+    void SetBeamMode(G4String mode) { fBeamMode = mode; }
+    void SetPhaseSpaceFile(G4String );
+    void SetStartZ(G4double z) { fStartZ = z; fUseStartZ = true; }
 
   private:
+    G4double GetGunPlaneZ();
+    void GenerateFromFile(G4Event* );
+    void GenerateFromModel(G4Event*, G4double z0);
+
     G4ParticleGun*          fParticleGun; // G4 particle gun
+    B2PrimaryGeneratorMessenger* fMessenger;
+
+    G4String                fBeamMode;    // gun, file or twiss
+    G4String                fPhaseSpaceFile;
+    B2PhaseSpaceReader*     fPhaseSpaceReader; // opened at the first event of this thread
+    B2BeamModel*            fBeamModel;
+
+    G4double                fGunPlaneZ;       // taken from the world volume
+    G4int                   fGeometryVersion; // geometry fGunPlaneZ was taken from
+    G4double                fStartZ;          // set with /AEgIS/beam/startZ
+    G4bool                  fUseStartZ;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
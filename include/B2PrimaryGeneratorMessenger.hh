@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PrimaryGeneratorMessenger.hh
+/// \brief Definition of the B2PrimaryGeneratorMessenger class
+
+#ifndef B2PrimaryGeneratorMessenger_h
+#define B2PrimaryGeneratorMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class B2PrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Messenger class that defines commands for B2PrimaryGeneratorAction.
+///
+/// It implements commands:
+/// - /AEgIS/beam/mode gun|file|twiss
+/// - /AEgIS/beam/file name
+/// - /AEgIS/beam/startZ value unit
+/// - /AEgIS/beam/twissX alpha beta emittance
+/// - /AEgIS/beam/twissY alpha beta emittance
+/// - /AEgIS/beam/divergence value unit
+/// - /AEgIS/beam/energySpread value unit gaussian|uniform
+/// - /AEgIS/beam/timeSpread value unit gaussian|uniform
+///
+/// The primary generator exists only in the worker threads, so the
+/// commands are available after /run/initialize (as /gun/ commands).
+
+class B2PrimaryGeneratorMessenger: public G4UImessenger
+{
+  public:
+    B2PrimaryGeneratorMessenger(B2PrimaryGeneratorAction* );
+    virtual ~B2PrimaryGeneratorMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    B2PrimaryGeneratorAction*  fPrimaryGenerator;
+
+    G4UIdirectory*           fBeamDirectory;
+
+    G4UIcmdWithAString* fModeCmd;
+    G4UIcmdWithAString* fFileCmd;
+    G4UIcmdWithADoubleAndUnit* fStartZCmd;
+
+    G4UIcommand*               fTwissXCmd;
+    G4UIcommand*               fTwissYCmd;
+    G4UIcmdWithADoubleAndUnit* fDivergenceCmd;
+    G4UIcommand*               fEnergySpreadCmd;
+    G4UIcommand*               fTimeSpreadCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
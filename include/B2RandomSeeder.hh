@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2RandomSeeder.hh
+/// \brief Definition of the B2RandomSeeder class
+
+#ifndef B2RandomSeeder_h
+#define B2RandomSeeder_h 1
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Reproducible seeding of every event.
+///
+/// Once a master seed is given (/AEgIS/random/seed), the random engine
+/// of the thread is reseeded at the start of each event with seeds
+/// derived from (master seed, job ID, run ID, event ID) by SplitMix64
+/// hashing. The streams of different jobs, runs and events are thus
+/// independent, and any event can be reproduced alone, independently of
+/// the number of threads or of the order in which the events are processed.
+/// In replay mode (/AEgIS/replay) the next events take the seeds of the
+/// given (run, event) instead of their own. While the run ID is held
+/// (/AEgIS/run/pairedBeamOn), the following runs keep the run ID of the
+/// first one, and so repeat its events with common random numbers.
+
+class B2RandomSeeder
+{
+  public:
+    static void SetMasterSeed(G4long seed) { fMasterSeed = seed; fEnabled = true; }
+    // back to the seeding of Geant4 (after a replay)
+    static void Disable() { fEnabled = false; }
+    static void SetJobID(G4long jobID) { fJobID = jobID; }
+    // set by the master at the start of each run: the Geant4 run ID, or the
+    // seed run ID of the chunk of a checkpointed run (B2Checkpoint)
+    static void SetRunID(G4int runID)
+      { if(fHoldRunID && fRunIDHeld) return; fRunID = runID; fRunIDHeld = fHoldRunID; }
+    static void HoldRunID(G4bool hold) { fHoldRunID = hold; fRunIDHeld = false; }
+
+    static G4bool IsEnabled() { return fEnabled; }
+    static G4long GetMasterSeed() { return fMasterSeed; }
+    static G4long GetJobID() { return fJobID; }
+    static G4int GetRunID() { return fRunID; }
+
+    static void SetReplayEvent(G4int runID, G4int eventID)
+      { fReplay = true; fReplayRunID = runID; fReplayEventID = eventID; }
+    static void ClearReplayEvent() { fReplay = false; }
+
+    // seeds of the event, seeds[2] = 0 terminates the list for the engine
+    static void GetEventSeeds(G4int runID, G4int eventID, long seeds[3]);
+    // reseed the engine of the calling thread for this event
+    static void SeedEvent(G4int runID, G4int eventID);
+
+  private:
+    static G4bool fEnabled;
+    static G4long fMasterSeed;
+    static G4long fJobID;
+    static G4int  fRunID;
+    static G4bool fHoldRunID;
+    static G4bool fRunIDHeld;
+    static G4bool fReplay;
+    static G4int  fReplayRunID;
+    static G4int  fReplayEventID;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -33,10 +33,33 @@
 #include "G4UserRunAction.hh"
 #include "globals.hh"
 #include "G4AnalysisManager.hh"
+#include "G4Accumulable.hh"
+#include "B2Checkpoint.hh"
+#include "B2MaxAccumulable.hh"
+
+#include <vector>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class G4Run;
+class G4Event;
+class B2RunMessenger;
+
+/// Trappable window: antiprotons reaching the detector with
+/// pz <= maxPz and pT <= maxPt (both as kinetic energy components).
+/// The counts are accumulated per thread and merged at the end of run.
+
+struct B2TrapWindow
+{
+  B2TrapWindow(G4double pz, G4double pt)
+    : maxPz(pz), maxPt(pt), sumW(0.), sumW2(0.) {}
+  G4bool Contains(G4double pz, G4double pt) const { return pz <= maxPz && pt <= maxPt; }
+
+  G4double maxPz;
+  G4double maxPt;
+  G4Accumulable<G4double> sumW;   // (weighted) number of trappable antiprotons
+  G4Accumulable<G4double> sumW2;  // sum of squared per-event counts
+};
 
 /// Run action class
 
@@ -49,13 +72,103 @@ public:
   virtual void BeginOfRunAction(const G4Run* run);
   virtual void   EndOfRunAction(const G4Run* run);
   virtual void AbortEvent();
-  virtual void AnnihilationEvent();
-  void KilledEvent();
-  void NormalEvent();
+  // weighted number of events, a split event counts in several
+  virtual void AnnihilationEvent(G4double weight = 1.);
+  void KilledEvent(G4double weight = 1.);
+  void NormalEvent(G4double weight = 1.);
+
+  void AddTrapWindowCounts(const std::vector<G4double>& eventCounts);
+  void CheckStoppingCriteria();
+  void RecordEventCost(const G4Event* event, G4double time, G4long steps);
+  void ReplayEvent(const G4String& logFile, G4long jobID, G4int runID, G4int eventID, G4int verbose);
+  void BeamOnCheckpointed(G4long nofEvents);
+  // the same events with the field on then off (common random numbers)
+  void BeamOnPaired(G4long nofEvents);
+  const std::vector<B2TrapWindow*>& GetTrapWindows() const { return fTrapWindows; }
+  // pT cut of hTrappableVsPz: that of the first trap window, or none
+  G4double GetTrappableMaxPt() const
+    { return fTrapWindows.empty() ? DBL_MAX : fTrapWindows.front()->maxPt; }
+
+  // Set methods
+  void SetOutputMode(G4String);
+  void SetOutputFile(G4String name) { fFileTemplate = name; }
+  void SetScratchDirectory(G4String dir) { fScratchDirectory = dir; }
+  void SetRecordFile(G4String name) { fRecordFile = name; }
+  void SetRecordPlane(G4double z) { fRecordPlane = z; }
+  void SetRecordStopTracks(G4bool stop) { fRecordStopTracks = stop; }
+
+  // Get methods
+  G4double GetRecordPlane() const { return fRecordPlane; }
+  G4bool GetRecordStopTracks() const { return fRecordStopTracks; }
+  void AddTrapWindow(G4double maxPz, G4double maxPt);
+  void SetTargetPrecision(G4double precision) { fTargetPrecision = precision; }
+  void SetPrecisionWindow(G4int window) { fPrecisionWindow = window; }
+  void SetTimeBudget(G4double time) { fTimeBudget = time; }
+  void SetBatchSize(G4int size) { fBatchSize = size; }
+  void SetSlowEventTime(G4double time) { fSlowEventTime = time; }
+  void SetSlowEventSteps(G4long steps) { fSlowEventSteps = steps; }
+  void SetSlowEventFile(G4String name) { fSlowEventFile = name; }
+  void SetCheckpointFile(G4String name) { fCheckpointFile = name; }
+  void SetCheckpointEvents(G4int nofEvents) { fCheckpointEvents = nofEvents; }
+  void SetResume(G4bool resume) { fResume = resume; }
+
 private:
-  G4int fAnnihilationEvents;
-  G4int fKilledEvents;
-  G4int fNormalEvents;
+  void FillTrappableHistogram();
+  void PrintTrapWindows(G4int nofEvents) const;
+  G4String ExpandFileName(const G4Run*) const;
+  void MoveOutputFile(const G4String& from, const G4String& to) const;
+
+  B2RunMessenger* fMessenger;
+
+  G4Accumulable<G4double> fAnnihilationEvents;
+  G4Accumulable<G4double> fKilledEvents;
+  G4Accumulable<G4double> fNormalEvents;
+
+  std::vector<B2TrapWindow*> fTrapWindows; // set with /AEgIS/score/trapWindow
+
+  G4bool fNtupleOutput; // write one ntuple row per antiproton
+  G4bool fHistoOutput;  // fill histograms during the run
+  G4bool fStreamOutput; // hits written by the B2OutputWriter thread
+
+  // output file name, %material1% %thickness1% %material2% %thickness2%
+  // %field% %run% and %seed% are replaced at the start of each run
+  G4String fFileTemplate;
+  G4String fScratchDirectory; // files are written here and moved at the end of run
+
+  // first stage of a two-stage simulation: the primaries crossing
+  // fRecordPlane are written to fRecordFile (see B2PhaseSpaceWriter)
+  G4String fRecordFile;
+  G4double fRecordPlane;
+  G4bool   fRecordStopTracks; // stop the tracks once they are recorded
+
+  // sequential stopping: the run is aborted once the trappable fraction in
+  // window fPrecisionWindow reaches fTargetPrecision or fTimeBudget is spent
+  G4double fTargetPrecision; // relative uncertainty, 0 = no precision target
+  G4int    fPrecisionWindow;
+  G4double fTimeBudget;      // wall time, 0 = no time limit
+  G4int    fBatchSize;       // events per thread between two checks
+  G4int    fBatchEvents;
+  G4double fBatchSumW;
+  G4double fBatchSumW2;
+
+  // cost of the events: the events above fSlowEventTime or fSlowEventSteps
+  // are written with their seeds to fSlowEventFile, to be rerun with /AEgIS/replay
+  G4Accumulable<G4double> fSumEventTime;
+  B2MaxAccumulable        fMaxEventTime;
+  G4Accumulable<G4double> fSumEventSteps;
+  B2MaxAccumulable        fMaxEventSteps;
+  G4Accumulable<G4int>    fSlowEvents;
+  G4double fSlowEventTime;  // 0 = no time threshold
+  G4long   fSlowEventSteps; // 0 = no step threshold
+  G4String fSlowEventFile;
+
+  // /AEgIS/checkpoint/beamOn runs chunks of fCheckpointEvents events and
+  // writes fCheckpoint to fCheckpointFile after each of them (master only)
+  G4String     fCheckpointFile;
+  G4int        fCheckpointEvents;
+  G4bool       fResume;
+  G4bool       fCheckpointing; // a chunk is running
+  B2Checkpoint fCheckpoint;
   
 };
 
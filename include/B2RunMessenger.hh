@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file B2RunMessenger.hh
+/// \brief Definition of the B2RunMessenger class
+
+#ifndef B2RunMessenger_h
+#define B2RunMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class B2RunAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithoutParameter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Messenger class that defines commands for B2RunAction.
+///
+/// It implements commands:
+/// - /AEgIS/output/mode ntuple|histo|both|stream
+/// - /AEgIS/output/file template
+/// - /AEgIS/output/scratchDir directory
+/// - /AEgIS/score/trapWindow maxPz maxPt unit
+/// - /AEgIS/run/precision relErr
+/// - /AEgIS/run/precisionWindow index
+/// - /AEgIS/run/timeBudget value unit
+/// - /AEgIS/run/batchSize nEvents
+/// - /AEgIS/run/pairedBeamOn nEvents
+/// - /AEgIS/record/file name
+/// - /AEgIS/record/plane value unit
+/// - /AEgIS/record/stopTracks true|false
+/// - /AEgIS/random/seed masterSeed
+/// - /AEgIS/random/jobID id
+/// - /AEgIS/profile/slowEventTime value unit
+/// - /AEgIS/profile/slowEventSteps nSteps
+/// - /AEgIS/profile/slowEventFile name
+/// - /AEgIS/replay file jobID runID eventID [trackingVerbose]
+/// - /AEgIS/checkpoint/file name
+/// - /AEgIS/checkpoint/events nEvents
+/// - /AEgIS/checkpoint/resume true|false
+/// - /AEgIS/checkpoint/beamOn nEvents
+/// - /AEgIS/physics/tableCache directory
+/// - /AEgIS/physics/printStoppingPower
+
+class B2RunMessenger: public G4UImessenger
+{
+  public:
+    B2RunMessenger(B2RunAction* );
+    virtual ~B2RunMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    B2RunAction*  fRunAction;
+
+    G4UIdirectory*           fOutputDirectory;
+    G4UIdirectory*           fScoreDirectory;
+    G4UIdirectory*           fRunDirectory;
+    G4UIdirectory*           fRecordDirectory;
+    G4UIdirectory*           fRandomDirectory;
+    G4UIdirectory*           fProfileDirectory;
+    G4UIdirectory*           fCheckpointDirectory;
+    G4UIdirectory*           fPhysicsDirectory;
+
+    G4UIcmdWithAString* fOutputModeCmd;
+    G4UIcmdWithAString* fOutputFileCmd;
+    G4UIcmdWithAString* fScratchDirCmd;
+    G4UIcommand*        fTrapWindowCmd;
+
+    G4UIcmdWithADouble*        fPrecisionCmd;
+    G4UIcmdWithAnInteger*      fPrecisionWindowCmd;
+    G4UIcmdWithADoubleAndUnit* fTimeBudgetCmd;
+    G4UIcmdWithAnInteger*      fBatchSizeCmd;
+
+    G4UIcmdWithAString*        fRecordFileCmd;
+    G4UIcmdWithADoubleAndUnit* fRecordPlaneCmd;
+    G4UIcmdWithABool*          fRecordStopTracksCmd;
+
+    G4UIcmdWithAnInteger*      fMasterSeedCmd;
+    G4UIcmdWithAnInteger*      fJobIDCmd;
+
+    G4UIcmdWithADoubleAndUnit* fSlowEventTimeCmd;
+    G4UIcmdWithAnInteger*      fSlowEventStepsCmd;
+    G4UIcmdWithAString*        fSlowEventFileCmd;
+    G4UIcommand*               fReplayCmd;
+
+    G4UIcmdWithAString*        fCheckpointFileCmd;
+    G4UIcmdWithAnInteger*      fCheckpointEventsCmd;
+    G4UIcmdWithABool*          fResumeCmd;
+    G4UIcmdWithAnInteger*      fCheckpointBeamOnCmd;
+    G4UIcmdWithAnInteger*      fPairedBeamOnCmd;
+
+    G4UIcmdWithAString*        fTableCacheCmd;
+    G4UIcmdWithoutParameter*   fPrintStoppingPowerCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -36,12 +36,16 @@
 #include "globals.hh"
 
 class B2EventAction;
+class B2SteppingMessenger;
 
 class G4LogicalVolume;
 class G4SteppingManager;
 
 /// Stepping action class
-/// 
+///
+/// Besides killing the tracks which cannot reach the detector, it
+/// implements the importance splitting and the Russian roulette before
+/// the field drift between the foil blocks, set with /AEgIS/bias/.
 
 class B2SteppingAction : public G4UserSteppingAction
 {
@@ -52,11 +56,39 @@ class B2SteppingAction : public G4UserSteppingAction
     // method from the base class
     virtual void UserSteppingAction(const G4Step*);
 
+    // Set methods
+    void SetSplitVolume(G4String name) { fSplitVolume = name; }
+    void SetSplitFactor(G4int factor) { fSplitFactor = factor; }
+    void SetSplitMaxEnergy(G4double energy) { fSplitMaxEnergy = energy; }
+    void SetRouletteMinPz(G4double pz) { fRouletteMinPz = pz; }
+    void SetRouletteMinRadius(G4double radius) { fRouletteMinRadius = radius; }
+    void SetRouletteSurvival(G4double probability) { fRouletteSurvival = probability; }
+    void SetRangeKill(G4bool state) { fRangeKill = state; }
+
   private:
+    void SplitTrack(const G4Step*);
+    void PlayRoulette(G4Track*);
+    G4bool StopsInVolume(const G4Step*);
+
     B2EventAction*  fEventAction;
     G4LogicalVolume* fScoringVolume;
     G4SteppingManager* fManager;
     G4int fStuckSteps;
+
+    B2SteppingMessenger* fMessenger;
+    G4String fSplitVolume;    // antiprotons entering this volume are split
+    G4int    fSplitFactor;    // in that many copies, 1 = no splitting
+    G4double fSplitMaxEnergy; // only below this kinetic energy, 0 = always
+
+    // Russian roulette for antiprotons going forward out of a foil block
+    // into the drift to the next one, with pz above fRouletteMinPz or
+    // radius above fRouletteMinRadius
+    G4double fRouletteMinPz;     // 0 = no pz condition
+    G4double fRouletteMinRadius; // 0 = no radius condition
+    G4double fRouletteSurvival;  // survival probability, 1 = no roulette
+    // antiprotons whose range is shorter than the distance to any boundary
+    // of their volume are annihilated there without tracking them further
+    G4bool fRangeKill;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2SteppingMessenger.hh
+/// \brief Definition of the B2SteppingMessenger class
+
+#ifndef B2SteppingMessenger_h
+#define B2SteppingMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class B2SteppingAction;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Messenger class that defines the variance reduction commands
+/// of B2SteppingAction.
+///
+/// It implements commands:
+/// - /AEgIS/bias/splitVolume name
+/// - /AEgIS/bias/splitFactor n
+/// - /AEgIS/bias/splitMaxEnergy value unit
+/// - /AEgIS/bias/rouletteMinPz value unit
+/// - /AEgIS/bias/rouletteMinRadius value unit
+/// - /AEgIS/bias/rouletteSurvival probability
+/// - /AEgIS/physics/rangeKill true|false
+///
+/// The stepping action exists only in the worker threads, so the
+/// commands are available after /run/initialize.
+
+class B2SteppingMessenger: public G4UImessenger
+{
+  public:
+    B2SteppingMessenger(B2SteppingAction* );
+    virtual ~B2SteppingMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    B2SteppingAction*  fSteppingAction;
+
+    G4UIdirectory*           fBiasDirectory;
+
+    G4UIcmdWithAString*        fSplitVolumeCmd;
+    G4UIcmdWithAnInteger*      fSplitFactorCmd;
+    G4UIcmdWithADoubleAndUnit* fSplitMaxEnergyCmd;
+    G4UIcmdWithADoubleAndUnit* fRouletteMinPzCmd;
+    G4UIcmdWithADoubleAndUnit* fRouletteMinRadiusCmd;
+    G4UIcmdWithADouble*        fRouletteSurvivalCmd;
+
+    G4UIcmdWithABool*          fRangeKillCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -34,6 +34,13 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "tls.hh"
 #include "G4FieldManager.hh"
+#include "B2bFoilParameterisation.hh"
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
 
 class B2MagneticField;
 class G4VPhysicalVolume;
@@ -43,11 +50,25 @@ class G4VSolid;
 class G4Material;
 class G4UserLimits;
 class G4GlobalMagFieldMessenger;
+class G4StepPoint;
 
 class B2bDetectorMessenger;
 
 /// Detector construction class to define materials, geometry
 /// and global uniform magnetic field.
+///
+/// The foil stack is the list of layers given with /AEgIS/stack/addLayer,
+/// or by default the two degrader foils with their metalization set by
+/// the /AEgIS/degrader/ commands. Touching layers with the same radius
+/// and step limit are placed as one parameterised volume. The layers
+/// touching each other are placed in a thin vacuum envelope, so that the
+/// navigation around the foils does not go through the voxels of the
+/// 150 cm long magnetic volume.
+///
+/// The overlaps are checked once for each list of volumes, so not again
+/// for every point of a thickness scan. In validation mode
+/// (/AEgIS/geometry/validation) they are checked, and the material table
+/// printed, at every build.
 
 class B2bDetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -69,14 +90,46 @@ class B2bDetectorConstruction : public G4VUserDetectorConstruction
     void SetFirstMetalizationMaterial(G4String);
     void SetSecondMetalizationMaterial(G4String);
     void SetMaxStep (G4double );
-    void SetCheckOverlaps(G4bool );
+    void SetValidation(G4bool );
+    void SetOverlapPoints(G4int );
     void SetMagneticField(G4bool );
+    // the field manager of a volume is per thread, each thread switches
+    // its own at the start of a run
+    void ApplyMagneticField() const;
+    void AddLayer(const B2FoilLayer& );
+    void ClearLayers();
+    void SetEnvelopes(G4bool );
+    void SetSmartless(G4double );
+
+    // times the navigation of straight rays through the foils
+    void BenchmarkNavigation(G4int nRays, G4double maxStep);
+
+    // Get methods
+    G4Material* GetFirstDegraderMaterial() const { return fFirstDegraderMaterial; }
+    G4Material* GetSecondDegraderMaterial() const { return fSecondDegraderMaterial; }
+    G4double GetFirstDegraderThickness() const { return fFirstDegraderThickness; }
+    G4double GetSecondDegraderThickness() const { return fSecondDegraderThickness; }
+    G4bool GetMagneticField() const { return fBFieldOn; }
+    // incremented each time the volumes are (re)built, so that the
+    // worker threads know when to update values taken from the geometry
+    static G4int GetGeometryVersion() { return fGeometryVersion; }
+    // true for the last layer of a foil block followed by a field drift
+    // to the next block, i.e. not for the layer in front of the detector
+    static G4bool IsDriftExit(const G4String& layerName) { return fDriftExitLayers.count(layerName) > 0; }
+    // name of the layer of the step point, also inside a parameterised foil
+    // (named after its first layer), or else of the physical volume
+    static G4String GetLayerName(const G4StepPoint*);
 
   private:
     // methods
     void DefineMaterials();
     G4VPhysicalVolume* DefineVolumes();
     G4Material* SetMaterial(G4LogicalVolume*, G4String);
+    // returns the downstream face of the last layer
+    G4double PlaceLayers(const std::vector<B2FoilLayer>&, G4double magneticStart,
+                         G4double detectorRadius);
+    // checks the daughters of the volume, and recursively theirs
+    void CheckOverlaps(G4LogicalVolume*);
     
     // data members
     G4LogicalVolume*   fWorldLV;         // pointer to the logical World
@@ -98,10 +151,6 @@ class B2bDetectorConstruction : public G4VUserDetectorConstruction
 
     // solids
     G4Tubs* fWorldS;
-    G4Tubs* fFirstDegraderS;
-    G4Tubs* fFirstMetalizationS;
-    G4Tubs* fSecondDegraderS;
-    G4Tubs* fSecondMetalizationS;
     G4Tubs* fDumpTubeS;
     G4Tubs* fDumpCapS;
     G4VSolid* fDumpS;
@@ -111,10 +160,6 @@ class B2bDetectorConstruction : public G4VUserDetectorConstruction
 
     // Physical Volume
     G4VPhysicalVolume* fWorldPV;
-    G4VPhysicalVolume* fFirstDegraderPV;
-    G4VPhysicalVolume* fFirstMetalizationPV;
-    G4VPhysicalVolume* fSecondDegraderPV;
-    G4VPhysicalVolume* fSecondMetalizationPV;
     G4VPhysicalVolume* fDumpPV;
     G4VPhysicalVolume* fDetectorPV;
     G4VPhysicalVolume* fMagneticPV;
@@ -126,6 +171,15 @@ class B2bDetectorConstruction : public G4VUserDetectorConstruction
     G4double           fFirstMetalizationThickness;
     G4double           fSecondMetalizationThickness;
 
+    std::vector<B2FoilLayer> fLayers; // /AEgIS/stack/ layers, empty = default foils
+
+    G4bool             fUseEnvelopes;    // place the foils in thin envelopes
+    G4double           fSmartless;       // voxels per daughter of the magnetic volume and envelopes
+    std::vector<G4LogicalVolume*> fEnvelopeLVs;
+    G4LogicalVolume*   fStackMotherLV;   // mother of the last layer and the detector
+    G4double           fStackMotherZ;    // its position in the magnetic volume
+    std::vector<std::pair<G4double,G4double> > fFoilRanges; // z of each foil in the magnetic volume
+
     G4double           fMagneticFieldStart;
 
     G4UserLimits*      fStepLimit;       // pointer to user step limits
@@ -136,10 +190,15 @@ class B2bDetectorConstruction : public G4VUserDetectorConstruction
 
     static G4ThreadLocal B2MagneticField* fMagneticField;
     static G4ThreadLocal G4FieldManager* fFieldMgr;
+    static std::atomic<G4int> fGeometryVersion;
+    static std::set<G4String> fDriftExitLayers;
+    static std::map<const G4VPhysicalVolume*, std::vector<G4String> > fGroupLayerNames;
 //*    static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger; 
                                          // magnetic field messenger
     
-    G4bool  fCheckOverlaps; // option to activate checking of volumes overlaps 
+    G4bool  fValidation;    // check overlaps at every build and print the materials
+    G4int   fOverlapPoints; // surface points per volume of the overlap checks
+    std::set<G4String> fCheckedTopologies; // volume lists already checked
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
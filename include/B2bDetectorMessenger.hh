@@ -40,6 +40,11 @@ class B2bDetectorConstruction;
 class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAnInteger;
+class G4UIcommand;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -53,6 +58,13 @@ class G4UIcmdWithADoubleAndUnit;
 /// - /AEgIS/degrader/setFirstMetalizationMaterial name 
 /// - /AEgIS/degrader/setSecondMetalizationMaterial name
 /// - /AEgIS/degrader/stepMax value unit
+/// - /AEgIS/stack/addLayer name material thickness [maxStep] [z] [radius]
+/// - /AEgIS/stack/clear
+/// - /AEgIS/geometry/envelopes true|false
+/// - /AEgIS/geometry/smartless value
+/// - /AEgIS/geometry/benchmark nRays [maxStep]
+/// - /AEgIS/geometry/validation true|false
+/// - /AEgIS/geometry/overlapPoints value
 
 class B2bDetectorMessenger: public G4UImessenger
 {
@@ -82,6 +94,17 @@ class B2bDetectorMessenger: public G4UImessenger
     G4UIcmdWithAString* fSecondMetalizationMaterialCmd;
     G4UIcmdWithAString* fMagneticFieldOnCmd;
 
+    G4UIdirectory*           fStackDirectory;
+    G4UIcommand*             fAddLayerCmd;
+    G4UIcmdWithoutParameter* fClearLayersCmd;
+
+    G4UIdirectory*           fGeometryDirectory;
+    G4UIcmdWithABool*        fEnvelopesCmd;
+    G4UIcmdWithADouble*      fSmartlessCmd;
+    G4UIcommand*             fBenchmarkCmd;
+    G4UIcmdWithABool*        fValidationCmd;
+    G4UIcmdWithAnInteger*    fOverlapPointsCmd;
+
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,141 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2bFoilParameterisation.hh
+/// \brief Definition of the B2bFoilParameterisation class
+
+#ifndef B2bFoilParameterisation_h
+#define B2bFoilParameterisation_h 1
+
+#include "globals.hh"
+#include "G4VPVParameterisation.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+class G4Material;
+class G4Box;
+
+// Dummy declarations to get rid of warnings ...
+class G4Trd;
+class G4Trap;
+class G4Cons;
+class G4Orb;
+class G4Sphere;
+class G4Ellipsoid;
+class G4Torus;
+class G4Para;
+class G4Hype;
+class G4Tubs;
+class G4Polycone;
+class G4Polyhedra;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// One layer of the foil stack (/AEgIS/stack/addLayer).
+///
+/// z is the upstream face of the layer measured from the beginning of
+/// the magnetic field, a negative z places the layer directly downstream
+/// of the previous one.
+
+struct B2FoilLayer
+{
+  G4String    name;
+  G4String    materialName;
+  G4Material* material = 0;
+  G4double    thickness = 0.;
+  G4double    z = -1.;
+  G4double    radius = 0.;
+  G4double    maxStep = 0.;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+///  A parameterisation of touching foil layers along Z.
+///
+///  The layers have the same radius and each its own thickness and
+///  material, so that a foil made of many thin layers is one volume
+///  for the navigation.
+
+class B2bFoilParameterisation : public G4VPVParameterisation
+{ 
+  public:
+  
+    // layers in the order of the copy numbers, startZ is the upstream
+    // face of the first one in the mother volume
+    B2bFoilParameterisation(const std::vector<B2FoilLayer>& layers,
+                            G4double startZ);
+    virtual ~B2bFoilParameterisation();
+   
+    void ComputeTransformation (const G4int copyNo,
+                                G4VPhysicalVolume* physVol) const;
+    
+    void ComputeDimensions (G4Tubs & foilLayer, const G4int copyNo,
+                            const G4VPhysicalVolume* physVol) const;
+
+    G4Material* ComputeMaterial (const G4int copyNo,
+                                 G4VPhysicalVolume* physVol,
+                                 const G4VTouchable* parentTouch = nullptr);
+
+  private:  // Dummy declarations to get rid of warnings ...
+
+    void ComputeDimensions (G4Box&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Trd&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Trap&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Cons&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Sphere&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Orb&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Ellipsoid&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Torus&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Para&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Hype&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Polycone&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+    void ComputeDimensions (G4Polyhedra&,const G4int,
+                            const G4VPhysicalVolume*) const {}
+
+  private:
+
+    G4double                 fRadius;          //  The radius of all the layers
+    std::vector<G4double>    fCentreZ;         //  The centre of each layer
+    std::vector<G4double>    fHalfThickness;   //  The half-thickness of each layer
+    std::vector<G4Material*> fMaterials;       //  The material of each layer
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,63 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2AntiprotonPhysicsList.cc
+/// \brief Implementation of the B2AntiprotonPhysicsList class
+
+#include "B2AntiprotonPhysicsList.hh"
+
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4DecayPhysics.hh"
+#include "G4StoppingPhysics.hh"
+#include "G4StepLimiterPhysics.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2AntiprotonPhysicsList::B2AntiprotonPhysicsList(G4int verbose)
+: G4VModularPhysicsList()
+{
+  SetVerboseLevel(verbose);
+
+  // EM physics, the most accurate models at low energy
+  RegisterPhysics(new G4EmStandardPhysics_option4(verbose));
+
+  // decays of the annihilation products
+  RegisterPhysics(new G4DecayPhysics(verbose));
+
+  // antiproton capture at rest ("CaptureAtRest" in B2SteppingAction)
+  RegisterPhysics(new G4StoppingPhysics(verbose));
+
+  // step limits of the foils (G4UserLimits)
+  RegisterPhysics(new G4StepLimiterPhysics());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2AntiprotonPhysicsList::~B2AntiprotonPhysicsList()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,145 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2BeamModel.cc
+/// \brief Implementation of the B2BeamModel class
+
+#include "B2BeamModel.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2BeamModel::B2BeamModel()
+ : fAlphaX(0.), fBetaX(1.*m), fEmittanceX(0.),
+   fAlphaY(0.), fBetaY(1.*m), fEmittanceY(0.),
+   fDivergence(0.),
+   fEnergySpread(0.),
+   fEnergyShape(kGaussian),
+   fTimeSpread(0.),
+   fTimeShape(kGaussian),
+   fGauss(fBatchSize),
+   fFlat(fBatchSize),
+   fNextGauss(fBatchSize),
+   fNextFlat(fBatchSize)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2BeamModel::~B2BeamModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2BeamModel::Sample(G4double meanEnergy, G4ThreeVector& position,
+                         G4ThreeVector& direction, G4double& energy, G4double& time)
+{
+  G4double u1 = NextGauss();
+  G4double u2 = NextGauss();
+  G4double x  = std::sqrt(fEmittanceX*fBetaX)*u1;
+  G4double xp = std::sqrt(fEmittanceX/fBetaX)*(-fAlphaX*u1 + u2);
+
+  u1 = NextGauss();
+  u2 = NextGauss();
+  G4double y  = std::sqrt(fEmittanceY*fBetaY)*u1;
+  G4double yp = std::sqrt(fEmittanceY/fBetaY)*(-fAlphaY*u1 + u2);
+
+  if(fDivergence > 0){
+    xp += fDivergence*NextGauss();
+    yp += fDivergence*NextGauss();
+  }
+
+  position.set(x, y, 0.);
+  direction.set(xp, yp, 1.);
+  direction = direction.unit();
+
+  energy = meanEnergy + Spread(fEnergySpread, fEnergyShape);
+  if(energy < 0.) energy = 0.;
+  time = Spread(fTimeSpread, fTimeShape);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2BeamModel::ClearBuffers()
+{
+  fNextGauss = fBatchSize;
+  fNextFlat = fBatchSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2BeamModel::SetTwissX(G4double alpha, G4double beta, G4double emittance)
+{
+  fAlphaX = alpha;
+  fBetaX = beta;
+  fEmittanceX = emittance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2BeamModel::SetTwissY(G4double alpha, G4double beta, G4double emittance)
+{
+  fAlphaY = alpha;
+  fBetaY = beta;
+  fEmittanceY = emittance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double B2BeamModel::NextGauss()
+{
+  if(fNextGauss == fBatchSize){
+    G4RandGauss::shootArray(G4Random::getTheEngine(), fBatchSize, fGauss.data());
+    fNextGauss = 0;
+  }
+  return fGauss[fNextGauss++];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double B2BeamModel::NextFlat()
+{
+  if(fNextFlat == fBatchSize){
+    G4RandFlat::shootArray(G4Random::getTheEngine(), fBatchSize, fFlat.data(), -1., 1.);
+    fNextFlat = 0;
+  }
+  return fFlat[fNextFlat++];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double B2BeamModel::Spread(G4double width, Shape shape)
+{
+  if(width <= 0.) return 0.;
+  if(shape == kUniform) return width*NextFlat();
+  return width*NextGauss();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,177 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2Checkpoint.cc
+/// \brief Implementation of the B2Checkpoint class
+
+#include "B2Checkpoint.hh"
+#include "B2RunAction.hh"
+#include "B2RandomSeeder.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2Checkpoint::B2Checkpoint()
+{
+  Reset(0, 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2Checkpoint::Reset(G4long totalEvents, G4int chunkEvents)
+{
+  fTotalEvents = totalEvents;
+  fChunkEvents = chunkEvents;
+  fChunksDone = 0;
+  fEventsDone = 0;
+  fMasterSeed = B2RandomSeeder::IsEnabled() ? B2RandomSeeder::GetMasterSeed() : -1;
+  fJobID = B2RandomSeeder::GetJobID();
+  fFirstRunID = -1;
+  fAnnihilations = 0.;
+  fNormal = 0.;
+  fKilled = 0.;
+  fWindows.clear();
+  fFiles.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2Checkpoint::Read(const G4String& fileName)
+{
+  std::ifstream file(fileName);
+  if(!file) return false;
+
+  Reset(0, 0);
+  std::string line;
+  while(std::getline(file, line)){
+    if(line.empty() || line[0] == '#') continue;
+    std::istringstream is(line);
+    std::string key;
+    is >> key;
+    if(key == "totalEvents") is >> fTotalEvents;
+    else if(key == "chunkEvents") is >> fChunkEvents;
+    else if(key == "chunksDone") is >> fChunksDone;
+    else if(key == "eventsDone") is >> fEventsDone;
+    else if(key == "masterSeed") is >> fMasterSeed;
+    else if(key == "jobID") is >> fJobID;
+    else if(key == "firstRunID") is >> fFirstRunID;
+    else if(key == "annihilations") is >> fAnnihilations;
+    else if(key == "normal") is >> fNormal;
+    else if(key == "killed") is >> fKilled;
+    else if(key == "window"){
+      std::array<G4double,4> window;
+      is >> window[0] >> window[1] >> window[2] >> window[3];
+      window[0] *= keV;
+      window[1] *= keV;
+      fWindows.push_back(window);
+    }
+    else if(key == "file"){
+      std::string name;
+      is >> name;
+      fFiles.push_back(name);
+    }
+  }
+  return fTotalEvents > 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2Checkpoint::Write(const G4String& fileName) const
+{
+  // written aside and renamed, a job killed while writing keeps the old file
+  G4String tmpName = fileName + ".tmp";
+  {
+    std::ofstream file(tmpName);
+    file.precision(17);
+    file << "# checkpoint of /AEgIS/checkpoint/beamOn, trap windows in keV" << std::endl;
+    file << "totalEvents " << fTotalEvents << std::endl;
+    file << "chunkEvents " << fChunkEvents << std::endl;
+    file << "chunksDone " << fChunksDone << std::endl;
+    file << "eventsDone " << fEventsDone << std::endl;
+    file << "masterSeed " << fMasterSeed << std::endl;
+    file << "jobID " << fJobID << std::endl;
+    file << "firstRunID " << fFirstRunID << std::endl;
+    file << "annihilations " << fAnnihilations << std::endl;
+    file << "normal " << fNormal << std::endl;
+    file << "killed " << fKilled << std::endl;
+    for(const auto& window : fWindows){
+      file << "window " << window[0]/keV << " " << window[1]/keV << " "
+           << window[2] << " " << window[3] << std::endl;
+    }
+    for(const auto& name : fFiles) file << "file " << name << std::endl;
+  }
+  std::rename(tmpName.c_str(), fileName.c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2Checkpoint::AddChunk(G4int nofEvents, G4double annihilations, G4double normal, G4double killed,
+                            const std::vector<B2TrapWindow*>& windows, const G4String& outputFile)
+{
+  fChunksDone++;
+  fEventsDone += nofEvents;
+  fAnnihilations += annihilations;
+  fNormal += normal;
+  fKilled += killed;
+  if(fWindows.size() != windows.size()){
+    fWindows.assign(windows.size(), {0.,0.,0.,0.});
+  }
+  for(std::size_t i = 0; i < windows.size(); i++){
+    fWindows[i][0] = windows[i]->maxPz;
+    fWindows[i][1] = windows[i]->maxPt;
+    fWindows[i][2] += windows[i]->sumW.GetValue();
+    fWindows[i][3] += windows[i]->sumW2.GetValue();
+  }
+  fFiles.push_back(outputFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2Checkpoint::Print() const
+{
+  G4cout << "Checkpointed run: " << fEventsDone << " of " << fTotalEvents
+         << " events in " << fChunksDone << " chunks" << G4endl;
+  G4cout << "Normal events:" << fNormal << G4endl;
+  G4cout << "Killed events:" << fKilled << G4endl;
+  G4cout << "Annihilation events:" << fAnnihilations << G4endl;
+  for(const auto& window : fWindows){
+    G4cout << "Trappable (pz<=" << window[0]/keV << " keV, pT<=" << window[1]/keV << " keV): "
+           << window[2] << " +- " << std::sqrt(window[3]);
+    if(fEventsDone > 0) G4cout << " (" << 100.*window[2]/fEventsDone << " % of " << fEventsDone << " events)";
+    G4cout << G4endl;
+  }
+  G4cout << "Output of the chunks (merge with hadd):" << G4endl;
+  for(const auto& name : fFiles) G4cout << "  " << name << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2EnergyLossTable.cc
+/// \brief Implementation of the B2EnergyLossTable class
+
+#include "B2EnergyLossTable.hh"
+
+#include "G4EmCalculator.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Exp.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2EnergyLossTable* B2EnergyLossTable::Instance()
+{
+  static G4ThreadLocal B2EnergyLossTable* instance = 0;
+  if(!instance) instance = new B2EnergyLossTable();
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2EnergyLossTable::B2EnergyLossTable()
+ : fParticle(0),
+   fNofMaterials(0),
+   fNofBins(0),
+   fMinEnergy(0.),
+   fMaxEnergy(0.),
+   fLogMinEnergy(0.),
+   fInvLogStep(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2EnergyLossTable::Build(const G4ParticleDefinition* particle,
+                              G4double minEnergy, G4double maxEnergy, G4int binsPerDecade)
+{
+  fParticle = particle;
+  fMinEnergy = minEnergy;
+  fMaxEnergy = maxEnergy;
+  fLogMinEnergy = G4Log(minEnergy);
+  G4double logStep = std::log(10.)/binsPerDecade;
+  fNofBins = G4int(std::ceil((G4Log(maxEnergy) - fLogMinEnergy)/logStep)) + 1;
+  fInvLogStep = 1./logStep;
+
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  fNofMaterials = materials->size();
+  fDEDX.assign(fNofMaterials*fNofBins, 0.);
+  fRange.assign(fNofMaterials*fNofBins, 0.);
+
+  G4EmCalculator calculator;
+  for(auto material : *materials){
+    G4double* dedx = &fDEDX[material->GetIndex()*fNofBins];
+    G4double* range = &fRange[material->GetIndex()*fNofBins];
+    for(G4int i = 0; i < fNofBins; i++){
+      // electronic and nuclear stopping, no cut
+      dedx[i] = calculator.ComputeTotalDEDX(G4Exp(fLogMinEnergy + i*logStep), fParticle, material);
+    }
+    // below the grid the stopping power is taken proportional to the
+    // velocity (R = 2E/S), above it R = integral of E/S over log(E)
+    range[0] = dedx[0] > 0. ? 2.*minEnergy/dedx[0] : DBL_MAX;
+    for(G4int i = 1; i < fNofBins; i++){
+      G4double e0 = G4Exp(fLogMinEnergy + (i-1)*logStep);
+      G4double e1 = G4Exp(fLogMinEnergy + i*logStep);
+      if(dedx[i-1] <= 0. || dedx[i] <= 0.) range[i] = DBL_MAX;
+      else range[i] = range[i-1] + 0.5*logStep*(e0/dedx[i-1] + e1/dedx[i]);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2EnergyLossTable::Validate() const
+{
+  if(!fParticle) return;
+  G4EmCalculator calculator;
+  G4double logStep = 1./fInvLogStep;
+  const G4double energies[5] = {1*keV, 10*keV, 50*keV, 100*keV, 200*keV};
+
+  G4cout << G4endl << "Stopping power and range of " << fParticle->GetParticleName()
+         << " (table / G4EmCalculator)" << G4endl;
+  for(auto material : *G4Material::GetMaterialTable()){
+    G4cout << "  " << material->GetName() << ":" << G4endl;
+    for(auto energy : energies){
+      if(energy < fMinEnergy || energy > fMaxEnergy) continue;
+      G4double dedx = calculator.ComputeTotalDEDX(energy, fParticle, material);
+      // range of the tracking: the delta rays of antiprotons below a few
+      // hundred keV are under the cuts, but it has no nuclear stopping
+      G4double range = calculator.GetRangeFromRestricteDEDX(energy, fParticle, material);
+      G4cout << "    " << std::setw(6) << energy/keV << " keV: "
+             << std::setw(10) << GetDEDX(material, energy)/(keV/um) << " / "
+             << std::setw(10) << dedx/(keV/um) << " keV/um, "
+             << std::setw(10) << GetRange(material, energy)/nm << " / "
+             << std::setw(10) << range/nm << " nm" << G4endl;
+    }
+    // interpolation error, largest between the grid points
+    G4double maxError = 0.;
+    for(G4int i = 0; i < fNofBins - 1; i++){
+      G4double energy = G4Exp(fLogMinEnergy + (i + 0.5)*logStep);
+      G4double dedx = calculator.ComputeTotalDEDX(energy, fParticle, material);
+      if(dedx > 0.) maxError = std::max(maxError, std::abs(GetDEDX(material, energy)/dedx - 1.));
+    }
+    G4cout << "    largest interpolation error of dE/dx: " << maxError*100. << " %" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
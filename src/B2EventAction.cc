@@ -30,19 +30,23 @@
 #include "B2EventAction.hh"
 
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4EventManager.hh"
 #include "G4TrajectoryContainer.hh"
 #include "G4Trajectory.hh"
 #include "G4ios.hh"
+#include "G4SystemOfUnits.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 B2EventAction::B2EventAction(B2RunAction* runAction)
 : G4UserEventAction(),
-  fRunAction(runAction)
+  fRunAction(runAction),
+  fStepCount(0)
 {
-  fAnnihilationEvent=false;
-  fKilledEvent=false;
+  fAnnihilatedWeight=0.;
+  fKilledWeight=0.;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -54,17 +58,44 @@ B2EventAction::~B2EventAction()
 
 void B2EventAction::BeginOfEventAction(const G4Event*)
 {
-  fAnnihilationEvent=false;
-  fKilledEvent=false;
+  fAnnihilatedWeight=0.;
+  fKilledWeight=0.;
+  fTrapWindowCounts.assign(fRunAction->GetTrapWindows().size(), 0.);
+  fStepCount = 0;
+  fEventStart = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2EventAction::AddDetectedAntiproton(G4double pz, G4double pt, G4double weight)
+{
+  const std::vector<B2TrapWindow*>& windows = fRunAction->GetTrapWindows();
+  for(std::size_t i = 0; i < fTrapWindowCounts.size(); i++){
+    if(windows[i]->Contains(pz, pt)) fTrapWindowCounts[i] += weight;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void B2EventAction::EndOfEventAction(const G4Event* event)
 {
-  if(fKilledEvent) fRunAction->KilledEvent();
-  else if(fAnnihilationEvent) fRunAction->AnnihilationEvent();
-  else fRunAction->NormalEvent();
+  // the primaries start with the weight of their particle and vertex,
+  // what is neither killed nor annihilated reaches the detector or the dump
+  // (not clamped at 0 after a roulette, the sum over events stays unbiased)
+  G4double primaryWeight = 0.;
+  for(G4int i = 0; i < event->GetNumberOfPrimaryVertex(); i++){
+    G4PrimaryVertex* vertex = event->GetPrimaryVertex(i);
+    for(G4int j = 0; j < vertex->GetNumberOfParticle(); j++){
+      primaryWeight += vertex->GetWeight()*vertex->GetPrimary(j)->GetWeight();
+    }
+  }
+  fRunAction->KilledEvent(fKilledWeight);
+  fRunAction->AnnihilationEvent(fAnnihilatedWeight);
+  fRunAction->NormalEvent(primaryWeight - fKilledWeight - fAnnihilatedWeight);
+  fRunAction->AddTrapWindowCounts(fTrapWindowCounts);
+  G4double eventTime = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - fEventStart).count()*s;
+  fRunAction->RecordEventCost(event, eventTime, fStepCount);
+  fRunAction->CheckStoppingCriteria();
   
   // get number of stored trajectories
 
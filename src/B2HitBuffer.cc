@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2HitBuffer.cc
+/// \brief Implementation of the B2HitBuffer class
+
+#include "B2HitBuffer.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2HitBuffer::B2HitBuffer(std::size_t capacity)
+ : fHead(0),
+   fTail(0)
+{
+  std::size_t size = 1;
+  while(size < capacity) size <<= 1;
+  fRecords.resize(size);
+  fMask = size - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2HitBuffer::~B2HitBuffer()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2HitBuffer::Push(const B2HitRecord& record)
+{
+  std::size_t head = fHead.load(std::memory_order_relaxed);
+  if(head - fTail.load(std::memory_order_acquire) == fRecords.size()) return false;
+  fRecords[head & fMask] = record;
+  fHead.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2HitBuffer::Pop(B2HitRecord& record)
+{
+  std::size_t tail = fTail.load(std::memory_order_relaxed);
+  if(tail == fHead.load(std::memory_order_acquire)) return false;
+  record = fRecords[tail & fMask];
+  fTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,26 +36,51 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <mutex>
 using namespace std;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+std::vector<G4double> B2MagneticField::aegisrB;
+std::vector<G4double> B2MagneticField::aegiszB;
+std::vector<G4double> B2MagneticField::aegisbR;
+std::vector<G4double> B2MagneticField::aegisbZ;
+G4int B2MagneticField::aegisbGranularity = 0;
+
+namespace
+{
+  std::once_flag fieldMapFlag;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 B2MagneticField::B2MagneticField(double posZ)
 : G4MagneticField(), 
   fMessenger(nullptr)
+{
+    fMagneticFieldStart = posZ; // Z position where magnetic field starts
+
+    // each worker builds its own field, the first one reads the map for all
+    std::call_once(fieldMapFlag, ReadFieldMap);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2MagneticField::ReadFieldMap()
 {
 //  read the full B-field map (array as CSV giving r,z, Br and Bz)
 //  this array will be stored as aegisrB,aegisrZ,aegisbR,aegisbZ 
 //  and set aegisbGranularity (expect 65592 entries in the field map)
-    fMagneticFieldStart = posZ; // Z position where magnetic field starts
-    
     FILE *fp;
     G4double A[4];
     ifstream ifs;
     string s1;
-    char c;
 
     aegisbGranularity=0;
+    aegisrB.assign(65592, 0.);
+    aegiszB.assign(65592, 0.);
+    aegisbR.assign(65592, 0.);
+    aegisbZ.assign(65592, 0.);
 
     fp = fopen("bfield.csv", "r");
     if(NULL == fp)
@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2NavigationBenchmark.cc
+/// \brief Implementation of the B2NavigationBenchmark class
+
+#include "B2NavigationBenchmark.hh"
+
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2NavigationBenchmark::Run(G4VPhysicalVolume* world,
+                                const std::vector<std::pair<G4double,G4double> >& foils,
+                                G4int nRays, G4double maxStep)
+{
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+
+  const G4double margin = 10*um;        // vacuum before and after the foil
+  const G4double rayRadius = 10*mm;      // the rays hit the foil within this radius
+  const G4double goldenAngle = 2.39996323; // rad
+
+  G4cout << "Navigation benchmark, " << nRays << " rays per foil, steps of at most "
+         << maxStep/nm << " nm" << G4endl;
+  for(std::size_t foil = 0; foil < foils.size(); foil++){
+    G4double zStart = foils[foil].first - margin;
+    G4double zEnd = foils[foil].second + margin;
+    // a ray stuck on a boundary is abandoned after twice the expected steps
+    G4long maxRaySteps = 2*static_cast<G4long>((zEnd - zStart)/maxStep) + 100;
+    G4long nSteps = 0;
+    G4long nBoundaries = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(G4int ray = 0; ray < nRays; ray++){
+      G4double r = rayRadius*std::sqrt((ray + 0.5)/nRays);
+      G4double phi = ray*goldenAngle;
+      G4ThreeVector position(r*std::cos(phi), r*std::sin(phi), zStart);
+      G4ThreeVector direction = G4ThreeVector(0.1*std::cos(phi), 0.1*std::sin(phi), 1.).unit();
+      navigator.LocateGlobalPointAndSetup(position, &direction, false, false);
+
+      G4long raySteps = 0;
+      while(position.z() < zEnd && raySteps < maxRaySteps){
+        G4double safety;
+        G4double step = navigator.ComputeStep(position, direction, maxStep, safety);
+        G4bool boundary = step <= maxStep;
+        if(!boundary) step = maxStep;
+        position += step*direction;
+        if(boundary){
+          navigator.SetGeometricallyLimitedStep();
+          navigator.LocateGlobalPointAndSetup(position, &direction, true);
+          nBoundaries++;
+        }else{
+          navigator.LocateGlobalPointWithinVolume(position);
+        }
+        raySteps++;
+      }
+      nSteps += raySteps;
+    }
+    std::chrono::duration<G4double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    G4cout << "  foil " << foil << " (" << foils[foil].first/cm << " to " << foils[foil].second/cm
+           << " cm): " << nSteps << " steps, " << nBoundaries << " boundaries, "
+           << (nSteps > 0 ? elapsed.count()/nSteps : 0.) << " ns per step" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
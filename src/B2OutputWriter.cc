@@ -0,0 +1,207 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2OutputWriter.cc
+/// \brief Implementation of the B2OutputWriter class
+
+#include "B2OutputWriter.hh"
+
+#include "G4Threading.hh"
+#include "G4ios.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "zlib.h"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2OutputWriter* B2OutputWriter::Instance()
+{
+  static B2OutputWriter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2OutputWriter::B2OutputWriter()
+ : fOpen(false),
+   fStop(false),
+   fNofRecords(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2OutputWriter::~B2OutputWriter()
+{
+  Close();
+  for(auto buffer : fBuffers) delete buffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2OutputWriter::Open(const G4String& fileName)
+{
+  if(fOpen) Close();
+
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if(!fFile){
+    G4cout << "WARNING: cannot open " << fileName << ", hits are not written" << G4endl;
+    return;
+  }
+  fFile.write("B2HITS03", 8);
+  fNofRecords = 0;
+
+  fStop = false;
+  fOpen = true;
+  fThread = std::thread(&B2OutputWriter::Run, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2OutputWriter::Close()
+{
+  if(!fOpen) return;
+
+  fStop = true;
+  fThread.join();
+  fOpen = false;
+  fFile.close();
+  G4cout << "Hit stream: " << fNofRecords << " antiprotons written" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2OutputWriter::Push(const B2HitRecord& record)
+{
+  B2HitBuffer* buffer = GetThreadBuffer();
+  // the buffer is only full if the disk cannot keep up, then wait for the writer
+  while(!buffer->Push(record)) std::this_thread::yield();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2HitBuffer* B2OutputWriter::GetThreadBuffer()
+{
+  // buffers are kept between runs, a worker thread registers its own once
+  static G4ThreadLocal B2HitBuffer* buffer = nullptr;
+  if(!buffer){
+    buffer = new B2HitBuffer(fBufferCapacity);
+    std::lock_guard<std::mutex> lock(fBuffersMutex);
+    fBuffers.push_back(buffer);
+  }
+  return buffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2OutputWriter::Run()
+{
+  while(!fStop){
+    if(Drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // the workers are done, write what is left
+  while(Drain() > 0) {}
+  if(!fEventID.empty()) WriteChunk();
+  fFile.flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t B2OutputWriter::Drain()
+{
+  std::vector<B2HitBuffer*> buffers;
+  {
+    std::lock_guard<std::mutex> lock(fBuffersMutex);
+    buffers = fBuffers;
+  }
+
+  std::size_t nofRecords = 0;
+  B2HitRecord record;
+  for(auto buffer : buffers){
+    while(buffer->Pop(record)){
+      fEventID.push_back(record.eventID);
+      fThreadID.push_back(record.threadID);
+      fX.push_back(record.x);
+      fY.push_back(record.y);
+      fZ.push_back(record.z);
+      fPx.push_back(record.px);
+      fPy.push_back(record.py);
+      fPz.push_back(record.pz);
+      fKineticEnergy.push_back(record.kineticEnergy);
+      fWeight.push_back(record.weight);
+      ++nofRecords;
+      if(fEventID.size() == fChunkSize) WriteChunk();
+    }
+  }
+  return nofRecords;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2OutputWriter::WriteChunk()
+{
+  std::uint32_t n = fEventID.size();
+
+  // the columns one after another, then compressed as one block
+  fRawChunk.clear();
+  auto addColumn = [this](auto& column){
+    std::size_t offset = fRawChunk.size();
+    std::size_t size = column.size()*sizeof(column[0]);
+    fRawChunk.resize(offset + size);
+    std::memcpy(fRawChunk.data() + offset, column.data(), size);
+    column.clear();
+  };
+  addColumn(fEventID);
+  addColumn(fThreadID);
+  addColumn(fX);
+  addColumn(fY);
+  addColumn(fZ);
+  addColumn(fPx);
+  addColumn(fPy);
+  addColumn(fPz);
+  addColumn(fKineticEnergy);
+  addColumn(fWeight);
+
+  uLongf zippedSize = compressBound(fRawChunk.size());
+  fZippedChunk.resize(zippedSize);
+  if(compress2(reinterpret_cast<Bytef*>(fZippedChunk.data()), &zippedSize,
+               reinterpret_cast<const Bytef*>(fRawChunk.data()), fRawChunk.size(),
+               Z_BEST_SPEED) != Z_OK){
+    G4cout << "WARNING: cannot compress " << n << " hits, they are not written" << G4endl;
+    return;
+  }
+  std::uint32_t nBytes = zippedSize;
+  fFile.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  fFile.write(reinterpret_cast<const char*>(&nBytes), sizeof(nBytes));
+  fFile.write(fZippedChunk.data(), nBytes);
+
+  fNofRecords += n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PhaseSpaceReader.cc
+/// \brief Implementation of the B2PhaseSpaceReader class
+
+#include "B2PhaseSpaceReader.hh"
+
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PhaseSpaceReader::B2PhaseSpaceReader(const G4String& fileName, G4int slice, G4int nofSlices)
+ : fFileName(fileName),
+   fBinary(true),
+   fData(nullptr),
+   fSize(0),
+   fBegin(nullptr),
+   fEnd(nullptr),
+   fCursor(nullptr),
+   fSlice(slice),
+   fNofLoops(0)
+{
+  fBinary = !G4StrUtil::ends_with(fileName, ".csv");
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat fileStat;
+  if(fd < 0 || fstat(fd, &fileStat) != 0 || fileStat.st_size == 0){
+    G4cout << "WARNING: cannot read phase-space file " << fileName << G4endl;
+    if(fd >= 0) close(fd);
+    return;
+  }
+  fSize = fileStat.st_size;
+  void* data = mmap(nullptr, fSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping stays valid
+  if(data == MAP_FAILED){
+    G4cout << "WARNING: cannot map phase-space file " << fileName << G4endl;
+    return;
+  }
+  fData = static_cast<const char*>(data);
+  // the file is read front to back, let the kernel read ahead and drop pages
+  madvise(data, fSize, MADV_SEQUENTIAL);
+
+  // cut the file in nofSlices parts, on record boundaries
+  if(nofSlices < 1 || slice < 0){
+    slice = 0;
+    nofSlices = 1;
+  }
+  if(fBinary){
+    std::size_t nofRecords = fSize/sizeof(B2PhaseSpaceRecord);
+    if(nofRecords < (std::size_t)nofSlices){
+      // fewer records than threads, everybody reads everything
+      slice = 0;
+      nofSlices = 1;
+    }
+    fBegin = fData + sizeof(B2PhaseSpaceRecord)*(nofRecords*slice/nofSlices);
+    fEnd   = fData + sizeof(B2PhaseSpaceRecord)*(nofRecords*(slice+1)/nofSlices);
+  }
+  else{
+    // a slice starts after the first line break following its nominal start
+    fBegin = slice == 0 ? fData : NextLine(fData + fSize*slice/nofSlices);
+    fEnd = slice == nofSlices-1 ? fData + fSize : NextLine(fData + fSize*(slice+1)/nofSlices);
+  }
+  fCursor = fBegin;
+
+  G4cout << "Phase-space file " << fileName << ": thread slice " << slice+1
+         << "/" << nofSlices << " (" << (fEnd - fBegin) << " bytes)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PhaseSpaceReader::~B2PhaseSpaceReader()
+{
+  if(fData) munmap(const_cast<char*>(fData), fSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2PhaseSpaceReader::Next(B2PhaseSpaceRecord& record)
+{
+  if(!IsOpen() || fBegin == fEnd) return false;
+  if(fBinary) return ReadBinary(record);
+  return ReadCSV(record);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2PhaseSpaceReader::ReadBinary(B2PhaseSpaceRecord& record)
+{
+  if(fCursor == fEnd) Rewind();
+  std::memcpy(&record, fCursor, sizeof(B2PhaseSpaceRecord));
+  fCursor += sizeof(B2PhaseSpaceRecord);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2PhaseSpaceReader::ReadCSV(B2PhaseSpaceRecord& record)
+{
+  // a slice without a single valid line is not retried forever
+  G4bool rewound = false;
+  while(true){
+    if(fCursor >= fEnd){
+      if(rewound) return false;
+      Rewind();
+      rewound = true;
+    }
+    const char* lineEnd = NextLine(fCursor);
+    if(lineEnd > fEnd) lineEnd = fEnd;
+
+    // the mapping is not null terminated, parse a copy of the line
+    char line[512];
+    std::size_t length = std::min<std::size_t>(lineEnd - fCursor, sizeof(line)-1);
+    std::memcpy(line, fCursor, length);
+    line[length] = '\0';
+    fCursor = lineEnd;
+
+    const char* pos = line;
+    while(std::isspace(*pos)) ++pos;
+    if(*pos == '\0' || *pos == '#' || std::isalpha(*pos)) continue;
+
+    G4double values[8] = {0., 0., 0., 0., 0., 0., 0., 1.};
+    G4int nofValues = 0;
+    char* next = const_cast<char*>(pos);
+    while(nofValues < 8){
+      G4double value = std::strtod(pos, &next);
+      if(next == pos) break;
+      values[nofValues++] = value;
+      pos = next;
+      while(*pos == ',' || std::isspace(*pos)) ++pos;
+    }
+    if(nofValues < 7) continue;
+
+    record.x = values[0];
+    record.y = values[1];
+    record.z = values[2];
+    record.px = values[3];
+    record.py = values[4];
+    record.pz = values[5];
+    record.t = values[6];
+    record.weight = values[7];
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* B2PhaseSpaceReader::NextLine(const char* pos) const
+{
+  const char* end = fData + fSize;
+  const char* newLine = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+  return newLine ? newLine + 1 : end;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhaseSpaceReader::Rewind()
+{
+  if(fNofLoops++ == 0){
+    G4cout << "WARNING: phase-space slice " << fSlice+1 << " of " << fFileName
+           << " is used up, its particles are reused" << G4endl;
+  }
+  fCursor = fBegin;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
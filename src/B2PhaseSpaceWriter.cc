@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PhaseSpaceWriter.cc
+/// \brief Implementation of the B2PhaseSpaceWriter class
+
+#include "B2PhaseSpaceWriter.hh"
+
+#include "G4AutoDelete.hh"
+#include "G4ios.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PhaseSpaceWriter* B2PhaseSpaceWriter::Instance()
+{
+  static B2PhaseSpaceWriter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PhaseSpaceWriter::B2PhaseSpaceWriter()
+ : fOpen(false),
+   fNofRecords(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PhaseSpaceWriter::~B2PhaseSpaceWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhaseSpaceWriter::Open(const G4String& fileName)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  if(fOpen) fFile.close();
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  fNofRecords = 0;
+  fOpen = (bool)fFile;
+  if(!fOpen) G4cout << "WARNING: cannot open phase-space file " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhaseSpaceWriter::Close()
+{
+  if(!fOpen) return;
+  Flush();
+  std::lock_guard<std::mutex> lock(fMutex);
+  fOpen = false;
+  fFile.close();
+  G4cout << "Phase space: " << fNofRecords << " particles recorded" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhaseSpaceWriter::Write(const B2PhaseSpaceRecord& record)
+{
+  std::vector<B2PhaseSpaceRecord>& buffer = GetThreadBuffer();
+  buffer.push_back(record);
+  if(buffer.size() >= fBufferSize) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhaseSpaceWriter::Flush()
+{
+  std::vector<B2PhaseSpaceRecord>& buffer = GetThreadBuffer();
+  if(buffer.empty()) return;
+  std::lock_guard<std::mutex> lock(fMutex);
+  if(fOpen){
+    fFile.write(reinterpret_cast<const char*>(buffer.data()),
+                buffer.size()*sizeof(B2PhaseSpaceRecord));
+    fNofRecords += buffer.size();
+  }
+  buffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<B2PhaseSpaceRecord>& B2PhaseSpaceWriter::GetThreadBuffer()
+{
+  static G4ThreadLocal std::vector<B2PhaseSpaceRecord>* buffer = nullptr;
+  if(!buffer){
+    buffer = new std::vector<B2PhaseSpaceRecord>;
+    buffer->reserve(fBufferSize);
+    G4AutoDelete::Register(buffer);
+  }
+  return *buffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,164 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PhysicsTableCache.cc
+/// \brief Implementation of the B2PhysicsTableCache class
+
+#include "B2PhysicsTableCache.hh"
+
+#include "G4VUserPhysicsList.hh"
+#include "G4RunManager.hh"
+#include "G4Material.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VUserPhysicsList* B2PhysicsTableCache::fPhysicsList = 0;
+G4String B2PhysicsTableCache::fPhysicsListName = "";
+G4String B2PhysicsTableCache::fDirectory = "";
+G4String B2PhysicsTableCache::fKey = "";
+G4bool   B2PhysicsTableCache::fStorePending = false;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // written last into a stored entry, an entry without it is incomplete
+  const char* kKeyFileName = "B2TableKey.txt";
+
+  // description of everything the tables depend on, hashed into the key
+  std::string KeyDescription(G4VUserPhysicsList* physicsList, const G4String& name)
+  {
+    std::ostringstream os;
+    os.precision(17);
+    os << "geant4 " << G4VERSION_TAG << "\n";
+    os << "physicsList " << name << "\n";
+    const char* particles[4] = {"gamma", "e-", "e+", "proton"};
+    for(auto particle : particles)
+      os << "cut " << particle << " " << physicsList->GetCutValue(particle)/mm << " mm\n";
+    for(auto material : *G4Material::GetMaterialTable())
+      os << "material " << material->GetName() << " " << material->GetDensity()/(g/cm3) << " g/cm3\n";
+    return os.str();
+  }
+
+  // FNV-1a, stable between compilers and jobs unlike std::hash
+  std::uint64_t Hash(const std::string& text)
+  {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for(unsigned char c : text){
+      hash ^= c;
+      hash *= 0x100000001B3ULL;
+    }
+    return hash;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhysicsTableCache::SetDirectory(const G4String& directory)
+{
+  fDirectory = directory;
+  // after /run/initialize the materials are known, before it this is
+  // done when the detector construction defines them
+  if(!G4Material::GetMaterialTable()->empty()) Prepare();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String B2PhysicsTableCache::GetKey()
+{
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx",
+                (unsigned long long)Hash(KeyDescription(fPhysicsList, fPhysicsListName)));
+  return key;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhysicsTableCache::Prepare()
+{
+  if(!IsEnabled() || !fPhysicsList || !G4Threading::IsMasterThread()) return;
+
+  G4String key = GetKey();
+  if(key == fKey) return;
+  fKey = key;
+
+  G4String entry = fDirectory + "/" + fKey;
+  if(std::filesystem::exists((entry + "/" + kKeyFileName).c_str())){
+    G4cout << "Physics tables retrieved from " << entry << G4endl;
+    fPhysicsList->SetPhysicsTableRetrieved(entry);
+    fStorePending = false;
+  }
+  else{
+    G4cout << "Physics tables not cached yet, they will be stored in " << entry << G4endl;
+    fPhysicsList->ResetPhysicsTableRetrieved();
+    fStorePending = true;
+  }
+  // the tables are (re)built or retrieved at the next run initialisation
+  G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PhysicsTableCache::StoreIfPending()
+{
+  if(!fStorePending || !fPhysicsList) return;
+  fStorePending = false;
+
+  // several jobs may fill the same cache: each one writes its own
+  // directory and renames it, the first one to finish wins
+  namespace fs = std::filesystem;
+  G4String entry = fDirectory + "/" + fKey;
+  std::ostringstream tmp;
+  tmp << entry << ".tmp" << ::getpid();
+  G4String tmpEntry = tmp.str();
+  std::error_code error;
+  fs::create_directories(tmpEntry.c_str(), error);
+  if(error || !fPhysicsList->StorePhysicsTable(tmpEntry)){
+    G4cout << "WARNING: physics tables could not be stored in " << tmpEntry << G4endl;
+    fs::remove_all(tmpEntry.c_str(), error);
+    return;
+  }
+  {
+    std::ofstream keyFile(tmpEntry + "/" + kKeyFileName);
+    keyFile << KeyDescription(fPhysicsList, fPhysicsListName);
+  }
+  fs::rename(tmpEntry.c_str(), entry.c_str(), error);
+  if(error) fs::remove_all(tmpEntry.c_str(), error);
+  else G4cout << "Physics tables stored in " << entry << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
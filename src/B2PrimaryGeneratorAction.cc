@@ -28,24 +28,43 @@
 /// \brief Implementation of the B2PrimaryGeneratorAction class
 
 #include "B2PrimaryGeneratorAction.hh"
+#include "B2PrimaryGeneratorMessenger.hh"
+#include "B2PhaseSpaceReader.hh"
+#include "B2BeamModel.hh"
+#include "B2bDetectorConstruction.hh"
+#include "B2RandomSeeder.hh"
 
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Tubs.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
-#include "G4INCLRandom.hh"
+#include "G4Threading.hh"
+#include "G4RunManagerFactory.hh"
+#include "G4MTRunManager.hh"
 
 #include "Randomize.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 B2PrimaryGeneratorAction::B2PrimaryGeneratorAction()
- : G4VUserPrimaryGeneratorAction()
+ : G4VUserPrimaryGeneratorAction(),
+   fBeamMode("gun"),
+   fPhaseSpaceFile(""),
+   fPhaseSpaceReader(nullptr),
+   fBeamModel(new B2BeamModel),
+   fGunPlaneZ(0.),
+   fGeometryVersion(-1),
+   fStartZ(0.),
+   fUseStartZ(false)
 {
+  fMessenger = new B2PrimaryGeneratorMessenger(this);
+
   G4int nofParticles = 1;
   fParticleGun = new G4ParticleGun(nofParticles);
 
@@ -64,6 +83,9 @@ B2PrimaryGeneratorAction::B2PrimaryGeneratorAction()
 B2PrimaryGeneratorAction::~B2PrimaryGeneratorAction()
 {
   delete fParticleGun;
+  delete fPhaseSpaceReader;
+  delete fBeamModel;
+  delete fMessenger;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -72,19 +94,23 @@ void B2PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
   // This function is called at the begining of event
 
-  // In order to avoid dependence of PrimaryGeneratorAction
-  // on DetectorConstruction class we get world volume
-  // from G4LogicalVolumeStore.
+  // the event stream only depends on (seed, job, run, event), and the
+  // samples drawn in advance for the previous event are thrown away
+  if(B2RandomSeeder::IsEnabled()){
+    B2RandomSeeder::SeedEvent(B2RandomSeeder::GetRunID(), anEvent->GetEventID());
+    fBeamModel->ClearBuffers();
+  }
 
-  G4double worldZHalfLength = 0;
-  G4LogicalVolume* worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("WorldLV");
-  G4Tubs* worldTube = NULL;
-  if ( worldLV ) worldTube = dynamic_cast<G4Tubs*>(worldLV->GetSolid());
-  if ( worldTube ) worldZHalfLength = worldTube->GetZHalfLength();
-  else  {
-    G4cerr << "World volume of tube not found." << G4endl;
-    G4cerr << "Perhaps you have changed geometry." << G4endl;
-    G4cerr << "The gun will be placed in the center." << G4endl;
+  if(fBeamMode == "file"){
+    GenerateFromFile(anEvent);
+    return;
+  }
+
+  G4double z0 = GetGunPlaneZ();
+
+  if(fBeamMode == "twiss"){
+    GenerateFromModel(anEvent, z0);
+    return;
   }
 
 //  the default is that the beam is on axis (x=y=0, z = start of volume)
@@ -93,12 +119,13 @@ void B2PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 // generate a Gaussian random number with standard deviation sigma
 
   G4double sigxy = 10*mm;
-//  G4double x0 = G4INCL::Random::gauss(sigxy) + 2.*mm;
-  G4double x0 = G4INCL::Random::gauss(sigxy);
-  G4double y0 = G4INCL::Random::gauss(sigxy);
+//  G4double x0 = G4RandGauss::shoot(0.,sigxy) + 2.*mm;
+  // G4RandGauss uses the engine of the thread, so it follows the event seeds
+  G4double x0 = G4RandGauss::shoot(0.,sigxy);
+  G4double y0 = G4RandGauss::shoot(0.,sigxy);
 
   // fParticleGun->SetParticlePosition(G4ThreeVector(0., 0., -worldZHalfLength/1.1));
-  fParticleGun->SetParticlePosition(G4ThreeVector(x0, y0, -worldZHalfLength/1.1));
+  fParticleGun->SetParticlePosition(G4ThreeVector(x0, y0, z0));
 
 //  and add an offset of 2 mm along x
 
@@ -115,3 +142,95 @@ void B2PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double B2PrimaryGeneratorAction::GetGunPlaneZ()
+{
+  if(fUseStartZ) return fStartZ;
+
+  // the world volume is only looked up again after the geometry was rebuilt
+  G4int geometryVersion = B2bDetectorConstruction::GetGeometryVersion();
+  if(geometryVersion == fGeometryVersion) return fGunPlaneZ;
+  fGeometryVersion = geometryVersion;
+
+  // the gun is placed relative to the world volume from G4LogicalVolumeStore
+
+  G4double worldZHalfLength = 0;
+  G4LogicalVolume* worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("WorldLV");
+  G4Tubs* worldTube = NULL;
+  if ( worldLV ) worldTube = dynamic_cast<G4Tubs*>(worldLV->GetSolid());
+  if ( worldTube ) worldZHalfLength = worldTube->GetZHalfLength();
+  else  {
+    G4cerr << "World volume of tube not found." << G4endl;
+    G4cerr << "Perhaps you have changed geometry." << G4endl;
+    G4cerr << "The gun will be placed in the center." << G4endl;
+  }
+
+  fGunPlaneZ = -worldZHalfLength/1.1;
+  return fGunPlaneZ;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PrimaryGeneratorAction::SetPhaseSpaceFile(G4String fileName)
+{
+  fPhaseSpaceFile = fileName;
+  // reopened at the next event, when the thread slice is known
+  delete fPhaseSpaceReader;
+  fPhaseSpaceReader = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PrimaryGeneratorAction::GenerateFromFile(G4Event* anEvent)
+{
+  if(!fPhaseSpaceReader){
+    // every worker reads its own part of the file
+    G4int slice = 0;
+    G4int nofSlices = 1;
+    // the factory gives the master of both the MT and the tasking run managers
+    if(G4Threading::IsWorkerThread() && G4RunManagerFactory::GetMTMasterRunManager()){
+      slice = G4Threading::G4GetThreadId();
+      nofSlices = G4RunManagerFactory::GetMTMasterRunManager()->GetNumberOfThreads();
+    }
+    fPhaseSpaceReader = new B2PhaseSpaceReader(fPhaseSpaceFile, slice, nofSlices);
+  }
+
+  B2PhaseSpaceRecord record;
+  if(!fPhaseSpaceReader->Next(record)){
+    G4ExceptionDescription msg;
+    msg << "No particles can be read from the phase-space file \"" << fPhaseSpaceFile << "\"";
+    G4Exception("B2PrimaryGeneratorAction::GenerateFromFile()", "B2Beam001",
+                RunMustBeAborted, msg);
+    return;
+  }
+
+  // the particle type is still set with /gun/particle
+  G4PrimaryVertex* vertex
+    = new G4PrimaryVertex(G4ThreeVector(record.x, record.y, record.z)*mm, record.t*ns);
+  G4PrimaryParticle* particle
+    = new G4PrimaryParticle(fParticleGun->GetParticleDefinition(),
+                            record.px*MeV, record.py*MeV, record.pz*MeV);
+  vertex->SetPrimary(particle);
+  vertex->SetWeight(record.weight);
+  anEvent->AddPrimaryVertex(vertex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PrimaryGeneratorAction::GenerateFromModel(G4Event* anEvent, G4double z0)
+{
+  G4ThreeVector position, direction;
+  G4double energy, time;
+  // spread around the /gun/energy setting, which is left untouched
+  fBeamModel->Sample(fParticleGun->GetParticleEnergy(), position, direction, energy, time);
+  position.setZ(z0);
+
+  G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+  G4PrimaryParticle* particle = new G4PrimaryParticle(fParticleGun->GetParticleDefinition());
+  particle->SetKineticEnergy(energy);
+  particle->SetMomentumDirection(direction);
+  vertex->SetPrimary(particle);
+  anEvent->AddPrimaryVertex(vertex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
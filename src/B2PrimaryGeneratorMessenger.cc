@@ -0,0 +1,192 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2PrimaryGeneratorMessenger.cc
+/// \brief Implementation of the B2PrimaryGeneratorMessenger class
+
+#include "B2PrimaryGeneratorMessenger.hh"
+#include "B2PrimaryGeneratorAction.hh"
+#include "B2BeamModel.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // alpha, beta [m] and rms geometric emittance [mm mrad]
+  G4UIcommand* CreateTwissCommand(const char* name, G4UImessenger* messenger)
+  {
+    G4UIcommand* command = new G4UIcommand(name, messenger);
+    command->SetGuidance("Twiss parameters at the gun plane: alpha, beta [m]");
+    command->SetGuidance("and rms geometric emittance [mm mrad].");
+    command->SetParameter(new G4UIparameter("alpha",'d',false));
+    G4UIparameter* betaPrm = new G4UIparameter("beta",'d',false);
+    betaPrm->SetParameterRange("beta>0.");
+    command->SetParameter(betaPrm);
+    G4UIparameter* emittancePrm = new G4UIparameter("emittance",'d',false);
+    emittancePrm->SetParameterRange("emittance>=0.");
+    command->SetParameter(emittancePrm);
+    command->AvailableForStates(G4State_PreInit,G4State_Idle);
+    return command;
+  }
+
+  // width with unit and shape of the distribution
+  G4UIcommand* CreateSpreadCommand(const char* name, const char* defaultUnit,
+                                   G4UImessenger* messenger)
+  {
+    G4UIcommand* command = new G4UIcommand(name, messenger);
+    command->SetParameter(new G4UIparameter("width",'d',false));
+    G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+    unitPrm->SetDefaultValue(defaultUnit);
+    command->SetParameter(unitPrm);
+    G4UIparameter* shapePrm = new G4UIparameter("shape",'s',true);
+    shapePrm->SetDefaultValue("gaussian");
+    shapePrm->SetParameterCandidates("gaussian uniform");
+    command->SetParameter(shapePrm);
+    command->AvailableForStates(G4State_PreInit,G4State_Idle);
+    return command;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PrimaryGeneratorMessenger::B2PrimaryGeneratorMessenger(B2PrimaryGeneratorAction* primaryGenerator)
+ : G4UImessenger(),
+   fPrimaryGenerator(primaryGenerator)
+{
+  fBeamDirectory = new G4UIdirectory("/AEgIS/beam/");
+  fBeamDirectory->SetGuidance("Antiproton beam control");
+
+  fModeCmd = new G4UIcmdWithAString("/AEgIS/beam/mode",this);
+  fModeCmd->SetGuidance("Select how the primary antiprotons are generated:");
+  fModeCmd->SetGuidance("  gun  - /gun/energy along z with a 10 mm Gaussian spot");
+  fModeCmd->SetGuidance("  file - particles read from /AEgIS/beam/file");
+  fModeCmd->SetGuidance("  twiss - parametric beam around /gun/energy (twissX, twissY,");
+  fModeCmd->SetGuidance("          divergence, energySpread, timeSpread)");
+  fModeCmd->SetParameterName("mode",false);
+  fModeCmd->SetCandidates("gun file twiss");
+  fModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fFileCmd = new G4UIcmdWithAString("/AEgIS/beam/file",this);
+  fFileCmd->SetGuidance("Phase-space file with x y z [mm] px py pz [MeV/c] t [ns] weight");
+  fFileCmd->SetGuidance("records, binary (8 doubles per record) or .csv.");
+  fFileCmd->SetGuidance("Each thread reads its own part of the file.");
+  fFileCmd->SetParameterName("fileName",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fStartZCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/beam/startZ",this);
+  fStartZCmd->SetGuidance("z of the gun plane for the gun and twiss modes. By default the");
+  fStartZCmd->SetGuidance("gun starts at the upstream end of the world; the first foil");
+  fStartZCmd->SetGuidance("stack starts 80 cm into the magnetic tube, at z = 5 cm.");
+  fStartZCmd->SetParameterName("z",false);
+  fStartZCmd->SetUnitCategory("Length");
+  fStartZCmd->SetDefaultUnit("cm");
+  fStartZCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTwissXCmd = CreateTwissCommand("/AEgIS/beam/twissX",this);
+  fTwissYCmd = CreateTwissCommand("/AEgIS/beam/twissY",this);
+
+  fDivergenceCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/beam/divergence",this);
+  fDivergenceCmd->SetGuidance("Additional rms angle in x and y, not correlated with the position.");
+  fDivergenceCmd->SetParameterName("divergence",false);
+  fDivergenceCmd->SetRange("divergence>=0.");
+  fDivergenceCmd->SetUnitCategory("Angle");
+  fDivergenceCmd->SetDefaultUnit("mrad");
+  fDivergenceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fEnergySpreadCmd = CreateSpreadCommand("/AEgIS/beam/energySpread","keV",this);
+  fEnergySpreadCmd->SetGuidance("Kinetic energy spread around /gun/energy:");
+  fEnergySpreadCmd->SetGuidance("rms for gaussian, half width for uniform.");
+
+  fTimeSpreadCmd = CreateSpreadCommand("/AEgIS/beam/timeSpread","ns",this);
+  fTimeSpreadCmd->SetGuidance("Spread of the start time around 0:");
+  fTimeSpreadCmd->SetGuidance("rms for gaussian, half width for uniform.");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2PrimaryGeneratorMessenger::~B2PrimaryGeneratorMessenger()
+{
+  delete fModeCmd;
+  delete fFileCmd;
+  delete fStartZCmd;
+  delete fTwissXCmd;
+  delete fTwissYCmd;
+  delete fDivergenceCmd;
+  delete fEnergySpreadCmd;
+  delete fTimeSpreadCmd;
+  delete fBeamDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{
+  if( command == fModeCmd )
+   { fPrimaryGenerator->SetBeamMode(newValue);}
+
+  if( command == fFileCmd )
+   { fPrimaryGenerator->SetPhaseSpaceFile(newValue);}
+
+  if( command == fStartZCmd )
+   { fPrimaryGenerator->SetStartZ(fStartZCmd->GetNewDoubleValue(newValue));}
+
+  B2BeamModel* beamModel = fPrimaryGenerator->GetBeamModel();
+
+  if( command == fTwissXCmd || command == fTwissYCmd ) {
+    G4double alpha, beta, emittance;
+    std::istringstream is(newValue);
+    is >> alpha >> beta >> emittance;
+    if( command == fTwissXCmd ) beamModel->SetTwissX(alpha, beta*m, emittance*mm*mrad);
+    else beamModel->SetTwissY(alpha, beta*m, emittance*mm*mrad);
+  }
+
+  if( command == fDivergenceCmd )
+   { beamModel->SetDivergence(fDivergenceCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fEnergySpreadCmd || command == fTimeSpreadCmd ) {
+    G4double width;
+    G4String unit, shape;
+    std::istringstream is(newValue);
+    is >> width >> unit >> shape;
+    width *= G4UIcommand::ValueOf(unit);
+    B2BeamModel::Shape spreadShape
+      = (shape == "uniform") ? B2BeamModel::kUniform : B2BeamModel::kGaussian;
+    if( command == fEnergySpreadCmd ) beamModel->SetEnergySpread(width, spreadShape);
+    else beamModel->SetTimeSpread(width, spreadShape);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2RandomSeeder.cc
+/// \brief Implementation of the B2RandomSeeder class
+
+#include "B2RandomSeeder.hh"
+
+#include "Randomize.hh"
+
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2RandomSeeder::fEnabled = false;
+G4long B2RandomSeeder::fMasterSeed = 0;
+G4long B2RandomSeeder::fJobID = 0;
+G4int  B2RandomSeeder::fRunID = 0;
+G4bool B2RandomSeeder::fHoldRunID = false;
+G4bool B2RandomSeeder::fRunIDHeld = false;
+G4bool B2RandomSeeder::fReplay = false;
+G4int  B2RandomSeeder::fReplayRunID = 0;
+G4int  B2RandomSeeder::fReplayEventID = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+  // SplitMix64 finaliser, consecutive inputs give uncorrelated outputs
+  std::uint64_t SplitMix(std::uint64_t x)
+  {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RandomSeeder::GetEventSeeds(G4int runID, G4int eventID, long seeds[3])
+{
+  std::uint64_t hash = SplitMix(fMasterSeed);
+  hash = SplitMix(hash ^ (std::uint64_t)fJobID);
+  hash = SplitMix(hash ^ (std::uint64_t)runID);
+  hash = SplitMix(hash ^ (std::uint64_t)eventID);
+  // positive 31-bit values are accepted by all CLHEP engines
+  seeds[0] = (long)(hash & 0x7FFFFFFF);
+  seeds[1] = (long)((hash >> 32) & 0x7FFFFFFF);
+  seeds[2] = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RandomSeeder::SeedEvent(G4int runID, G4int eventID)
+{
+  long seeds[3];
+  if(fReplay) GetEventSeeds(fReplayRunID, fReplayEventID, seeds);
+  else GetEventSeeds(runID, eventID, seeds);
+  G4Random::setTheSeeds(seeds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,24 +28,115 @@
 /// \brief Implementation of the B2RunAction class
 
 #include "B2RunAction.hh"
+#include "B2RunMessenger.hh"
+#include "B2OutputWriter.hh"
+#include "B2PhaseSpaceWriter.hh"
+#include "B2RandomSeeder.hh"
+#include "B2PhysicsTableCache.hh"
+#include "B2bDetectorConstruction.hh"
 
 #include "G4Run.hh"
+#include "G4Event.hh"
+#include "G4UImanager.hh"
+#include "G4Exception.hh"
 #include "G4RunManager.hh"
+#include "G4AccumulableManager.hh"
+#include "G4AutoLock.hh"
+#include "G4Material.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Tallies shared by all threads for the sequential stopping. The workers
+// add their batches here, so the precision is judged on the whole run.
+namespace
+{
+  G4Mutex stoppingMutex = G4MUTEX_INITIALIZER;
+  G4int    sharedEvents = 0;
+  G4double sharedSumW = 0.;
+  G4double sharedSumW2 = 0.;
+  std::atomic<G4bool> stopRequested(false);
+  G4String stopReason;
+  std::chrono::steady_clock::time_point runStart;
+
+  // output file names of the current run, chosen by the master
+  G4String outputFile;  // final location, without extension
+  G4String writtenFile; // where the file is written, without extension
+
+  // slow events of all threads, opened by the master for the run
+  G4Mutex slowEventMutex = G4MUTEX_INITIALIZER;
+  std::ofstream slowEventLog;
+
+  // first seed run ID not yet used by a checkpointed run of this job
+  G4int nextCheckpointRunID = 0;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 B2RunAction::B2RunAction()
- : G4UserRunAction()
+ : G4UserRunAction(),
+   fAnnihilationEvents(0.),
+   fKilledEvents(0.),
+   fNormalEvents(0.),
+   fNtupleOutput(true),
+   fHistoOutput(false),
+   fStreamOutput(false),
+   fFileTemplate("man_output"),
+   fScratchDirectory(""),
+   fRecordFile(""),
+   fRecordPlane(4.*cm),
+   fRecordStopTracks(true),
+   fTargetPrecision(0.),
+   fPrecisionWindow(0),
+   fTimeBudget(0.),
+   fBatchSize(1000),
+   fBatchEvents(0),
+   fBatchSumW(0.),
+   fBatchSumW2(0.),
+   fSumEventTime(0.),
+   fMaxEventTime("maxEventTime"),
+   fSumEventSteps(0.),
+   fMaxEventSteps("maxEventSteps"),
+   fSlowEvents(0),
+   fSlowEventTime(0.),
+   fSlowEventSteps(0),
+   fSlowEventFile("slow_events.txt"),
+   fCheckpointFile(""),
+   fCheckpointEvents(10000),
+   fResume(false),
+   fCheckpointing(false)
 {
-  fAnnihilationEvents = 0;
-  fKilledEvents = 0;
-  fNormalEvents = 0;
+  fMessenger = new B2RunMessenger(this);
+
+  // event counters are merged from the worker threads at the end of run
+  G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(fAnnihilationEvents);
+  accumulableManager->RegisterAccumulable(fKilledEvents);
+  accumulableManager->RegisterAccumulable(fNormalEvents);
+  accumulableManager->RegisterAccumulable(fSumEventTime);
+  accumulableManager->RegisterAccumulable(&fMaxEventTime);
+  accumulableManager->RegisterAccumulable(fSumEventSteps);
+  accumulableManager->RegisterAccumulable(&fMaxEventSteps);
+  accumulableManager->RegisterAccumulable(fSlowEvents);
+
   // set printing event number per each 100 events
   G4RunManager::GetRunManager()->SetPrintProgress(1000);
   auto man = G4AnalysisManager::Instance();
   man->SetNtupleMerging(true);
+  // only the ntuples and histograms selected with /AEgIS/output/mode are written
+  man->SetActivation(true);
 
   man->SetFirstNtupleId(1);
+  man->SetFirstHistoId(1);
 
   man->CreateNtuple("fPosition","Antiproton Position in mm");
   man->CreateNtupleDColumn("x_mm");
@@ -58,51 +149,205 @@ B2RunAction::B2RunAction()
   man->CreateNtupleDColumn("py_keV");
   man->CreateNtupleDColumn("pz_keV");
   man->CreateNtupleDColumn("kineticEnergy_keV");
+  man->CreateNtupleDColumn("weight");
+  // pairs the antiprotons of /AEgIS/run/pairedBeamOn
+  man->CreateNtupleIColumn("eventID");
   man->FinishNtuple();
 
   man->CreateNtuple("fRunSummary","Summary of the events in the run");
-  man->CreateNtupleIColumn("annihilations");
-  man->CreateNtupleIColumn("normal");
-  man->CreateNtupleIColumn("killed");
+  man->CreateNtupleDColumn("annihilations");
+  man->CreateNtupleDColumn("normal");
+  man->CreateNtupleDColumn("killed");
+  // -1 when the events are not seeded by B2RandomSeeder, the G4long seed
+  // and job ID are stored as double, exact up to 2^53
+  man->CreateNtupleIColumn("runID");
+  man->CreateNtupleDColumn("masterSeed");
+  man->CreateNtupleDColumn("jobID");
   man->FinishNtuple();
-  
+
+  man->CreateNtuple("fTrapWindows","Trappable antiprotons for each window in keV");
+  man->CreateNtupleDColumn("maxPz_keV");
+  man->CreateNtupleDColumn("maxPt_keV");
+  man->CreateNtupleDColumn("count");
+  man->CreateNtupleDColumn("countError");
+  man->FinishNtuple();
+
+  // histograms of the antiprotons reaching the detector,
+  // binned as in analyse/GetMomentumDistribution.C (0.1 keV bins)
+  man->CreateH1("hPz","Antiproton p_{z} in keV",1100,0.,110.);
+  man->CreateH1("hPt","Antiproton p_{T} in keV",1100,0.,110.);
+  man->CreateH1("hKineticEnergy","Antiproton kinetic energy in keV",1100,0.,110.);
+  man->CreateH1("hRadius","Antiproton radial position in mm",150,0.,15.);
+  // pz of the antiprotons within the pT cut of the first trap window,
+  // made cumulative at the end of run
+  man->CreateH1("hTrappableVsPz","Antiprotons with p_{z} equal or less, p_{T} in the first trap window",
+                1100,0.,110.);
+  man->SetH1XAxisTitle(1,"p_{z} [keV]");
+  man->SetH1XAxisTitle(2,"p_{T} [keV]");
+  man->SetH1XAxisTitle(3,"E_{kin} [keV]");
+  man->SetH1XAxisTitle(4,"r [mm]");
+  man->SetH1XAxisTitle(5,"p_{z} [keV]");
+
+  man->CreateH2("hpzvspt","p_{z} vs p_{T}",220,0.,110.,220,0.,110.);
+  man->SetH2XAxisTitle(1,"p_{T} [keV]");
+  man->SetH2YAxisTitle(1,"p_{z} [keV]");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 B2RunAction::~B2RunAction()
-{}
+{
+  delete fMessenger;
+  for(auto window : fTrapWindows) delete window;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void B2RunAction::BeginOfRunAction(const G4Run*)
+void B2RunAction::BeginOfRunAction(const G4Run* run)
 { 
   //inform the runManager to save random number seed
   G4RunManager::GetRunManager()->SetRandomNumberStore(false);
+  G4AccumulableManager::Instance()->Reset();
+  fBatchEvents = 0;
+  fBatchSumW = 0.;
+  fBatchSumW2 = 0.;
+  // the master starts the run before any worker processes an event
+  if(IsMaster()){
+    sharedEvents = 0;
+    sharedSumW = 0.;
+    sharedSumW2 = 0.;
+    stopRequested = false;
+    stopReason = "";
+    runStart = std::chrono::steady_clock::now();
+    // the physics tables are built by now, keep them for the next jobs
+    B2PhysicsTableCache::StoreIfPending();
+    // the seeds of a checkpointed run must not depend on how often it was
+    // restarted, nor repeat those of an earlier (checkpointed) run
+    if(fCheckpointing){
+      if(fCheckpoint.GetFirstRunID() < 0)
+        fCheckpoint.SetFirstRunID(std::max(run->GetRunID(), nextCheckpointRunID));
+      nextCheckpointRunID = std::max(nextCheckpointRunID,
+                                     fCheckpoint.GetFirstRunID() + fCheckpoint.GetChunksDone() + 1);
+    }
+    B2RandomSeeder::SetRunID(fCheckpointing ? fCheckpoint.GetSeedRunID() : run->GetRunID());
+    if(B2RandomSeeder::IsEnabled()){
+      G4cout << "Run " << B2RandomSeeder::GetRunID() << " seeded per event from master seed "
+             << B2RandomSeeder::GetMasterSeed() << ", job " << B2RandomSeeder::GetJobID() << G4endl;
+    }
+    if(fSlowEventTime > 0 || fSlowEventSteps > 0){
+      slowEventLog.open(fSlowEventFile, std::ios::app | std::ios::ate);
+      if(slowEventLog.tellp() == 0)
+        slowEventLog << "# jobID runID eventID masterSeed time_s steps" << std::endl;
+      if(!B2RandomSeeder::IsEnabled()){
+        G4cout << "WARNING: slow events can only be replayed with /AEgIS/random/seed set" << G4endl;
+      }
+    }
+    if(fTargetPrecision > 0 && fPrecisionWindow >= (G4int)fTrapWindows.size()){
+      G4cout << "WARNING: trap window " << fPrecisionWindow << " is not defined,"
+             << " the target precision is ignored" << G4endl;
+    }
+  }
+  else{
+    // /AEgIS/BField only switched the field of the master since the last run
+    static_cast<const B2bDetectorConstruction*>
+      (G4RunManager::GetRunManager()->GetUserDetectorConstruction())->ApplyMagneticField();
+  }
   auto man = G4AnalysisManager::Instance();
 
-  G4String filename = "man_output.root";
-  man->OpenFile(filename);
+  // activation has to be set before the file is opened
+  man->SetNtupleActivation(1,fNtupleOutput);
+  man->SetNtupleActivation(2,fNtupleOutput);
+  man->SetH1Activation(fHistoOutput);
+  man->SetH2Activation(fHistoOutput);
+
+  // the seed in the name is the master one, so the workers use its file name
+  if(IsMaster()){
+    outputFile = ExpandFileName(run);
+    writtenFile = outputFile;
+    if(!fScratchDirectory.empty()){
+      writtenFile = fScratchDirectory + "/" + std::filesystem::path(outputFile.c_str()).filename().string();
+    }
+  }
+  man->OpenFile(writtenFile + ".root");
+
+  // the writer thread has to run before the workers start pushing hits
+  if(IsMaster() && fStreamOutput) B2OutputWriter::Instance()->Open(writtenFile + ".hits");
+  if(IsMaster() && !fRecordFile.empty()) B2PhaseSpaceWriter::Instance()->Open(fRecordFile);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void B2RunAction::EndOfRunAction(const G4Run *)
+void B2RunAction::EndOfRunAction(const G4Run* run)
 {
-  G4cout << "Run finished with:"<<G4endl;
-  G4cout << "Normal events:"<<fNormalEvents<<G4endl;
-  G4cout << "Killed events:"<<fKilledEvents<<G4endl;
-  G4cout << "Annihilation events:"<<fAnnihilationEvents<<G4endl;
+  // the workers end their run before the master closes the file
+  B2PhaseSpaceWriter::Instance()->Flush();
+  if(IsMaster()) B2PhaseSpaceWriter::Instance()->Close();
+
+  G4AccumulableManager::Instance()->Merge();
   auto man = G4AnalysisManager::Instance();
 
-  man->FillNtupleIColumn(3,0,fAnnihilationEvents);
-  man->FillNtupleIColumn(3,1,fNormalEvents);
-  man->FillNtupleIColumn(3,2,fKilledEvents);
-  man->AddNtupleRow(3);
+  // the summary is written once, by the master, from the merged counters
+  if(IsMaster()){
+    G4cout << "Run finished with:"<<G4endl;
+    G4cout << "Normal events:"<<fNormalEvents.GetValue()<<G4endl;
+    G4cout << "Killed events:"<<fKilledEvents.GetValue()<<G4endl;
+    G4cout << "Annihilation events:"<<fAnnihilationEvents.GetValue()<<G4endl;
+    PrintTrapWindows(run->GetNumberOfEvent());
+    if(run->GetNumberOfEvent() > 0){
+      G4cout << "Event time: mean " << fSumEventTime.GetValue()/run->GetNumberOfEvent()/ms
+             << " ms, max " << fMaxEventTime.GetValue()/ms << " ms" << G4endl;
+      G4cout << "Event steps: mean " << fSumEventSteps.GetValue()/run->GetNumberOfEvent()
+             << ", max " << fMaxEventSteps.GetValue() << G4endl;
+    }
+    if(slowEventLog.is_open()){
+      slowEventLog.close();
+      G4cout << fSlowEvents.GetValue() << " slow events written to " << fSlowEventFile << G4endl;
+    }
+    if(stopRequested){
+      G4cout << "Run stopped after " << run->GetNumberOfEvent() << " of "
+             << run->GetNumberOfEventToBeProcessed() << " events: " << stopReason << G4endl;
+    }
+
+    man->FillNtupleDColumn(3,0,fAnnihilationEvents.GetValue());
+    man->FillNtupleDColumn(3,1,fNormalEvents.GetValue());
+    man->FillNtupleDColumn(3,2,fKilledEvents.GetValue());
+    man->FillNtupleIColumn(3,3,B2RandomSeeder::GetRunID());
+    man->FillNtupleDColumn(3,4,B2RandomSeeder::IsEnabled() ? (G4double)B2RandomSeeder::GetMasterSeed() : -1.);
+    man->FillNtupleDColumn(3,5,B2RandomSeeder::IsEnabled() ? (G4double)B2RandomSeeder::GetJobID() : -1.);
+    man->AddNtupleRow(3);
+
+    for(auto window : fTrapWindows){
+      man->FillNtupleDColumn(4,0,window->maxPz/keV);
+      man->FillNtupleDColumn(4,1,window->maxPt/keV);
+      man->FillNtupleDColumn(4,2,window->sumW.GetValue());
+      man->FillNtupleDColumn(4,3,std::sqrt(window->sumW2.GetValue()));
+      man->AddNtupleRow(4);
+    }
+  }
+
+  // worker histograms are already merged when the master gets here
+  if(IsMaster() && fHistoOutput) FillTrappableHistogram();
 
   man->Write();
   man->CloseFile();
 
+  // all workers have finished, so the buffers only need a last drain
+  if(IsMaster()){
+    if(fStreamOutput){
+      B2OutputWriter::Instance()->Close();
+      MoveOutputFile(writtenFile + ".hits", outputFile + ".hits");
+    }
+    MoveOutputFile(writtenFile + ".root", outputFile + ".root");
+
+    // the chunk is complete on disk, only now it counts as done
+    if(fCheckpointing){
+      fCheckpoint.AddChunk(run->GetNumberOfEvent(), fAnnihilationEvents.GetValue(),
+                           fNormalEvents.GetValue(), fKilledEvents.GetValue(),
+                           fTrapWindows, outputFile + ".root");
+      G4Random::saveEngineStatus((fCheckpointFile + ".rng").c_str());
+      fCheckpoint.Write(fCheckpointFile);
+    }
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -113,20 +358,351 @@ void B2RunAction::AbortEvent(){
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void B2RunAction::AnnihilationEvent(){
-  fAnnihilationEvents+=1;
+void B2RunAction::AnnihilationEvent(G4double weight){
+  fAnnihilationEvents+=weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::KilledEvent(G4double weight){
+  fKilledEvents+=weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::NormalEvent(G4double weight){
+  fNormalEvents+=weight;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void B2RunAction::KilledEvent(){
-  fKilledEvents+=1;
+void B2RunAction::SetOutputMode(G4String mode){
+  fNtupleOutput = (mode == "ntuple" || mode == "both");
+  fHistoOutput = (mode == "histo" || mode == "both");
+  fStreamOutput = (mode == "stream");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void B2RunAction::NormalEvent(){
-  fNormalEvents+=1;
+G4String B2RunAction::ExpandFileName(const G4Run* run) const {
+  auto detector = static_cast<const B2bDetectorConstruction*>
+    (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+
+  // same naming as condor_scripts/DegraderSimulation.sh: thickness in nm, no G4_ prefix
+  auto materialName = [](const G4Material* material){
+    if(!material) return G4String("none");
+    G4String name = material->GetName();
+    if(G4StrUtil::starts_with(name, "G4_")) name.erase(0,3);
+    return name;
+  };
+  auto thicknessName = [](G4double thickness){
+    std::ostringstream os;
+    os << thickness/nm;
+    return os.str();
+  };
+
+  std::vector<std::pair<G4String,G4String>> tokens = {
+    {"%material1%", materialName(detector->GetFirstDegraderMaterial())},
+    {"%thickness1%", thicknessName(detector->GetFirstDegraderThickness())},
+    {"%material2%", materialName(detector->GetSecondDegraderMaterial())},
+    {"%thickness2%", thicknessName(detector->GetSecondDegraderThickness())},
+    {"%field%", detector->GetMagneticField() ? "on" : "off"},
+    {"%run%", std::to_string(run->GetRunID())},
+    {"%seed%", std::to_string(B2RandomSeeder::IsEnabled() ? B2RandomSeeder::GetMasterSeed()
+                                                          : G4Random::getTheSeed())}
+  };
+
+  G4String name = fFileTemplate;
+  for(const auto& token : tokens){
+    std::size_t pos;
+    while((pos = name.find(token.first)) != std::string::npos)
+      name.replace(pos, token.first.size(), token.second);
+  }
+  // the extension is added for each output
+  if(G4StrUtil::ends_with(name, ".root")) name.erase(name.size()-5);
+  // every chunk of a checkpointed run has its own file
+  if(fCheckpointing) name += "_part" + std::to_string(fCheckpoint.GetChunksDone());
+  return name;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::MoveOutputFile(const G4String& from, const G4String& to) const {
+  if(from == to) return;
+  namespace fs = std::filesystem;
+  std::error_code error;
+  fs::path source(from.c_str());
+  fs::path target(to.c_str());
+  if(target.has_parent_path()) fs::create_directories(target.parent_path(), error);
+  // rename does not work across file systems (scratch -> EOS), copy instead
+  fs::rename(source, target, error);
+  if(error){
+    error.clear();
+    fs::copy_file(source, target, fs::copy_options::overwrite_existing, error);
+    if(!error) fs::remove(source, error);
+  }
+  if(error){
+    G4cout << "WARNING: cannot move " << from << " to " << to << ": " << error.message() << G4endl;
+  }
+  else G4cout << "Output written to " << to << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::AddTrapWindow(G4double maxPz, G4double maxPt){
+  B2TrapWindow* window = new B2TrapWindow(maxPz, maxPt);
+  // the command is broadcast, so every thread registers the same windows in the same order
+  G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(window->sumW);
+  accumulableManager->RegisterAccumulable(window->sumW2);
+  fTrapWindows.push_back(window);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::AddTrapWindowCounts(const std::vector<G4double>& eventCounts){
+  for(std::size_t i = 0; i < eventCounts.size() && i < fTrapWindows.size(); i++){
+    fTrapWindows[i]->sumW += eventCounts[i];
+    fTrapWindows[i]->sumW2 += eventCounts[i]*eventCounts[i];
+  }
+  if(fPrecisionWindow < (G4int)eventCounts.size()){
+    fBatchSumW += eventCounts[fPrecisionWindow];
+    fBatchSumW2 += eventCounts[fPrecisionWindow]*eventCounts[fPrecisionWindow];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::CheckStoppingCriteria(){
+  if(fTargetPrecision <= 0 && fTimeBudget <= 0) return;
+
+  if(!stopRequested){
+    if(++fBatchEvents < fBatchSize) return;
+
+    G4AutoLock lock(&stoppingMutex);
+    sharedEvents += fBatchEvents;
+    sharedSumW += fBatchSumW;
+    sharedSumW2 += fBatchSumW2;
+    fBatchEvents = 0;
+    fBatchSumW = 0.;
+    fBatchSumW2 = 0.;
+
+    // relative uncertainty of the (weighted) trappable fraction, which reduces
+    // to the binomial sqrt((1-p)/(n*p)) for unit weights
+    if(fTargetPrecision > 0 && sharedSumW > 0){
+      G4double variance = sharedSumW2 - sharedSumW*sharedSumW/sharedEvents;
+      G4double precision = std::sqrt(std::max(variance, 0.))/sharedSumW;
+      if(precision <= fTargetPrecision && !stopRequested){
+        stopReason = "relative precision " + std::to_string(precision) + " reached";
+        stopRequested = true;
+      }
+    }
+    G4double elapsed = std::chrono::duration<G4double>(std::chrono::steady_clock::now() - runStart).count()*s;
+    if(fTimeBudget > 0 && elapsed >= fTimeBudget && !stopRequested){
+      stopReason = "time budget of " + std::to_string(fTimeBudget/s) + " s spent";
+      stopRequested = true;
+    }
+    if(!stopRequested) return;
+  }
+
+  // soft abort: the current event is finished, no new events are started
+  G4RunManager::GetRunManager()->AbortRun(true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::RecordEventCost(const G4Event* event, G4double time, G4long steps){
+  fSumEventTime += time;
+  fSumEventSteps += (G4double)steps;
+  fMaxEventTime.Update(time);
+  fMaxEventSteps.Update((G4double)steps);
+
+  G4bool slow = (fSlowEventTime > 0 && time >= fSlowEventTime)
+             || (fSlowEventSteps > 0 && steps >= fSlowEventSteps);
+  if(!slow) return;
+  fSlowEvents += 1;
+
+  // (master seed, job, run, event) is all /AEgIS/replay needs to rerun it
+  G4int runID = B2RandomSeeder::GetRunID();
+  G4AutoLock lock(&slowEventMutex);
+  if(!slowEventLog.is_open()) return;
+  slowEventLog << B2RandomSeeder::GetJobID() << " " << runID << " " << event->GetEventID() << " "
+               << B2RandomSeeder::GetMasterSeed() << " " << time/s << " " << steps << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::ReplayEvent(const G4String& logFile, G4long jobID, G4int runID, G4int eventID,
+                              G4int verbose){
+  std::ifstream log(logFile);
+  std::string line;
+  G4bool found = false;
+  G4long masterSeed = 0;
+  while(std::getline(log, line)){
+    if(line.empty() || line[0] == '#') continue;
+    std::istringstream is(line);
+    G4int lineRun, lineEvent;
+    G4long lineJob, lineSeed;
+    if(!(is >> lineJob >> lineRun >> lineEvent >> lineSeed)) continue;
+    // event IDs repeat in every run and job
+    if(lineJob != jobID || lineRun != runID || lineEvent != eventID) continue;
+    masterSeed = lineSeed;
+    found = true;
+    break;
+  }
+  if(!found){
+    G4ExceptionDescription ed;
+    ed << "Event " << eventID << " of run " << runID << " (job " << jobID << ") is not in " << logFile;
+    G4Exception("B2RunAction::ReplayEvent()", "B2Replay001", JustWarning, ed);
+    return;
+  }
+
+  G4cout << "Replaying event " << eventID << " of run " << runID << " (job " << jobID
+         << ", master seed " << masterSeed << ")" << G4endl;
+  // the seeding and the output of the next runs are restored after the replay
+  G4bool seeded = B2RandomSeeder::IsEnabled();
+  G4long previousSeed = B2RandomSeeder::GetMasterSeed();
+  G4long previousJob = B2RandomSeeder::GetJobID();
+  G4String fileTemplate = fFileTemplate;
+  G4String recordFile = fRecordFile;
+  G4double slowEventTime = fSlowEventTime;
+  G4long slowEventSteps = fSlowEventSteps;
+  // own output file, no phase-space record, not logged as slow again
+  fFileTemplate = "replay_job" + std::to_string(jobID) + "_run" + std::to_string(runID)
+                + "_event" + std::to_string(eventID);
+  fRecordFile = "";
+  fSlowEventTime = 0.;
+  fSlowEventSteps = 0;
+
+  B2RandomSeeder::SetMasterSeed(masterSeed);
+  B2RandomSeeder::SetJobID(jobID);
+  B2RandomSeeder::SetReplayEvent(runID, eventID);
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+  uiManager->ApplyCommand("/tracking/verbose " + std::to_string(verbose));
+  uiManager->ApplyCommand("/run/beamOn 1");
+  uiManager->ApplyCommand("/tracking/verbose 0");
+  B2RandomSeeder::ClearReplayEvent();
+
+  if(seeded) B2RandomSeeder::SetMasterSeed(previousSeed);
+  else B2RandomSeeder::Disable();
+  B2RandomSeeder::SetJobID(previousJob);
+  fFileTemplate = fileTemplate;
+  fRecordFile = recordFile;
+  fSlowEventTime = slowEventTime;
+  fSlowEventSteps = slowEventSteps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::BeamOnCheckpointed(G4long nofEvents){
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+  if(fCheckpointFile.empty()){
+    G4cout << "WARNING: no /AEgIS/checkpoint/file, the run is not checkpointed" << G4endl;
+    uiManager->ApplyCommand("/run/beamOn " + std::to_string(nofEvents));
+    return;
+  }
+
+  G4bool resumed = fResume && fCheckpoint.Read(fCheckpointFile)
+                && fCheckpoint.GetTotalEvents() == nofEvents;
+  if(fResume && !resumed){
+    G4cout << "WARNING: no checkpoint of " << nofEvents << " events in "
+           << fCheckpointFile << ", starting from the beginning" << G4endl;
+  }
+  if(resumed){
+    G4cout << "Resuming from " << fCheckpointFile << " after " << fCheckpoint.GetEventsDone()
+           << " events (" << fCheckpoint.GetChunksDone() << " chunks)" << G4endl;
+    // the same seeds as before the restart
+    if(fCheckpoint.GetMasterSeed() >= 0){
+      B2RandomSeeder::SetMasterSeed(fCheckpoint.GetMasterSeed());
+      B2RandomSeeder::SetJobID(fCheckpoint.GetJobID());
+    }
+    else{
+      G4Random::restoreEngineStatus((fCheckpointFile + ".rng").c_str());
+    }
+  }
+  else{
+    fCheckpoint.Reset(nofEvents, fCheckpointEvents);
+  }
+
+  fCheckpointing = true;
+  while(fCheckpoint.GetEventsDone() < nofEvents){
+    G4long chunk = std::min<G4long>(fCheckpoint.GetChunkEvents(), nofEvents - fCheckpoint.GetEventsDone());
+    G4int chunksDone = fCheckpoint.GetChunksDone();
+    uiManager->ApplyCommand("/run/beamOn " + std::to_string(chunk));
+    if(fCheckpoint.GetChunksDone() == chunksDone){
+      G4cout << "WARNING: chunk " << chunksDone << " did not finish, checkpointed run stopped" << G4endl;
+      break;
+    }
+    // stopping criteria of /AEgIS/run apply to the chunk being run
+    if(stopRequested) break;
+  }
+  fCheckpointing = false;
+  fCheckpoint.Print();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::BeamOnPaired(G4long nofEvents){
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+  auto detector = static_cast<const B2bDetectorConstruction*>
+    (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+
+  // the pairs are made by seeding both runs per event from the same seeds
+  if(!B2RandomSeeder::IsEnabled()){
+    G4cout << "WARNING: no /AEgIS/random/seed, the paired runs are seeded from "
+           << G4Random::getTheSeed() << G4endl;
+    B2RandomSeeder::SetMasterSeed(G4Random::getTheSeed());
+  }
+  // one output file per field state
+  G4String fileTemplate = fFileTemplate;
+  if(fFileTemplate.find("%field%") == std::string::npos){
+    if(G4StrUtil::ends_with(fFileTemplate, ".root")) fFileTemplate.erase(fFileTemplate.size()-5);
+    fFileTemplate += "_field%field%";
+  }
+  G4bool fieldOn = detector->GetMagneticField();
+
+  B2RandomSeeder::HoldRunID(true);
+  for(G4String field : {"on", "off"}){
+    uiManager->ApplyCommand("/AEgIS/BField " + field);
+    uiManager->ApplyCommand("/run/beamOn " + std::to_string(nofEvents));
+  }
+  B2RandomSeeder::HoldRunID(false);
+
+  uiManager->ApplyCommand(G4String("/AEgIS/BField ") + (fieldOn ? "on" : "off"));
+  fFileTemplate = fileTemplate;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunAction::PrintTrapWindows(G4int nofEvents) const{
+  for(auto window : fTrapWindows){
+    G4double count = window->sumW.GetValue();
+    G4cout << "Trappable (pz<=" << window->maxPz/keV << " keV, pT<=" << window->maxPt/keV << " keV): "
+           << count << " +- " << std::sqrt(window->sumW2.GetValue());
+    if(nofEvents > 0) G4cout << " (" << 100.*count/nofEvents << " % of " << nofEvents << " events)";
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Number of antiprotons with pz equal or less than the upper edge of each bin,
+// i.e. the trappable count as a function of the pz cut, with the pT cut of
+// the first trap window (none without a trap window).
+void B2RunAction::FillTrappableHistogram(){
+  auto man = G4AnalysisManager::Instance();
+  auto hTrappable = man->GetH1(5);
+  if(!hTrappable) return;
+
+  // the pz distribution filled by B2TrackerSD becomes its integral
+  std::vector<G4double> counts(hTrappable->axis().bins());
+  for(unsigned int iBin = 0; iBin < counts.size(); iBin++) counts[iBin] = hTrappable->bin_Sw(iBin);
+  hTrappable->reset();
+  G4double integral = 0;
+  for(unsigned int iBin = 0; iBin < counts.size(); iBin++){
+    integral += counts[iBin];
+    man->FillH1(5, hTrappable->axis().bin_center(iBin), integral);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
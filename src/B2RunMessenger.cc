@@ -0,0 +1,425 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file B2RunMessenger.cc
+/// \brief Implementation of the B2RunMessenger class
+
+#include "B2RunMessenger.hh"
+#include "B2RunAction.hh"
+#include "B2RandomSeeder.hh"
+#include "B2PhysicsTableCache.hh"
+#include "B2EnergyLossTable.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4AntiProton.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2RunMessenger::B2RunMessenger(B2RunAction* runAction)
+ : G4UImessenger(),
+   fRunAction(runAction)
+{
+  fOutputDirectory = new G4UIdirectory("/AEgIS/output/");
+  fOutputDirectory->SetGuidance("Simulation output control");
+
+  fOutputModeCmd = new G4UIcmdWithAString("/AEgIS/output/mode",this);
+  fOutputModeCmd->SetGuidance("Select what is written to the output file:");
+  fOutputModeCmd->SetGuidance("  ntuple - one ntuple row per detected antiproton");
+  fOutputModeCmd->SetGuidance("  histo  - only histograms filled during the run");
+  fOutputModeCmd->SetGuidance("  both   - ntuples and histograms");
+  fOutputModeCmd->SetGuidance("  stream - hits written by a separate writer thread");
+  fOutputModeCmd->SetGuidance("           to man_output.hits (see analyse/ReadHitStream.C)");
+  fOutputModeCmd->SetParameterName("outputMode",false);
+  fOutputModeCmd->SetCandidates("ntuple histo both stream");
+  fOutputModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fOutputFileCmd = new G4UIcmdWithAString("/AEgIS/output/file",this);
+  fOutputFileCmd->SetGuidance("Output file name (.root/.hits is added), evaluated at each run.");
+  fOutputFileCmd->SetGuidance("Tokens: %material1% %thickness1% %material2% %thickness2%");
+  fOutputFileCmd->SetGuidance("        %field% %run% %seed%, thickness in nm, e.g.");
+  fOutputFileCmd->SetGuidance("(braces would be taken as UI aliases)");
+  fOutputFileCmd->SetGuidance("  /AEgIS/output/file out/%thickness1%%material1%+%thickness2%%material2%_run%run%");
+  fOutputFileCmd->SetParameterName("template",false);
+  fOutputFileCmd->SetDefaultValue("man_output");
+  fOutputFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fScratchDirCmd = new G4UIcmdWithAString("/AEgIS/output/scratchDir",this);
+  fScratchDirCmd->SetGuidance("Write the output files in a local directory and move them");
+  fScratchDirCmd->SetGuidance("to the /AEgIS/output/file location at the end of each run.");
+  fScratchDirCmd->SetGuidance("An empty value writes directly to the final location.");
+  fScratchDirCmd->SetParameterName("directory",true);
+  fScratchDirCmd->SetDefaultValue("");
+  fScratchDirCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fScoreDirectory = new G4UIdirectory("/AEgIS/score/");
+  fScoreDirectory->SetGuidance("Live scoring of the antiprotons reaching the detector");
+
+  fTrapWindowCmd = new G4UIcommand("/AEgIS/score/trapWindow",this);
+  fTrapWindowCmd->SetGuidance("Count antiprotons with pz <= maxPz and pT <= maxPt.");
+  fTrapWindowCmd->SetGuidance("Can be used several times to score several windows.");
+  G4UIparameter* maxPzPrm = new G4UIparameter("maxPz",'d',false);
+  maxPzPrm->SetParameterRange("maxPz>0.");
+  fTrapWindowCmd->SetParameter(maxPzPrm);
+  G4UIparameter* maxPtPrm = new G4UIparameter("maxPt",'d',false);
+  maxPtPrm->SetParameterRange("maxPt>0.");
+  fTrapWindowCmd->SetParameter(maxPtPrm);
+  G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultValue("keV");
+  fTrapWindowCmd->SetParameter(unitPrm);
+  fTrapWindowCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRunDirectory = new G4UIdirectory("/AEgIS/run/");
+  fRunDirectory->SetGuidance("Sequential stopping of the run, paired runs");
+
+  fPrecisionCmd = new G4UIcmdWithADouble("/AEgIS/run/precision",this);
+  fPrecisionCmd->SetGuidance("Stop the run once the relative uncertainty of the");
+  fPrecisionCmd->SetGuidance("trappable count in the selected window is reached.");
+  fPrecisionCmd->SetGuidance("/run/beamOn N is then an upper limit. 0 disables it.");
+  fPrecisionCmd->SetParameterName("relErr",false);
+  fPrecisionCmd->SetRange("relErr>=0.");
+  fPrecisionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPrecisionWindowCmd = new G4UIcmdWithAnInteger("/AEgIS/run/precisionWindow",this);
+  fPrecisionWindowCmd->SetGuidance("Index of the trap window used by /AEgIS/run/precision");
+  fPrecisionWindowCmd->SetGuidance("(in the order of the /AEgIS/score/trapWindow commands).");
+  fPrecisionWindowCmd->SetParameterName("index",false);
+  fPrecisionWindowCmd->SetDefaultValue(0);
+  fPrecisionWindowCmd->SetRange("index>=0");
+  fPrecisionWindowCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTimeBudgetCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/run/timeBudget",this);
+  fTimeBudgetCmd->SetGuidance("Stop the run after the given wall-clock time. 0 disables it.");
+  fTimeBudgetCmd->SetParameterName("time",false);
+  fTimeBudgetCmd->SetRange("time>=0.");
+  fTimeBudgetCmd->SetUnitCategory("Time");
+  fTimeBudgetCmd->SetDefaultUnit("s");
+  fTimeBudgetCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBatchSizeCmd = new G4UIcmdWithAnInteger("/AEgIS/run/batchSize",this);
+  fBatchSizeCmd->SetGuidance("Number of events each thread processes between two");
+  fBatchSizeCmd->SetGuidance("checks of the stopping criteria.");
+  fBatchSizeCmd->SetParameterName("nEvents",false);
+  fBatchSizeCmd->SetRange("nEvents>0");
+  fBatchSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRecordDirectory = new G4UIdirectory("/AEgIS/record/");
+  fRecordDirectory->SetGuidance("First stage of a two-stage simulation: record the beam");
+  fRecordDirectory->SetGuidance("upstream of the foils, then start the foil scans from it");
+  fRecordDirectory->SetGuidance("with /AEgIS/beam/file and /AEgIS/beam/mode file.");
+
+  fRecordFileCmd = new G4UIcmdWithAString("/AEgIS/record/file",this);
+  fRecordFileCmd->SetGuidance("Write the primary antiprotons crossing /AEgIS/record/plane");
+  fRecordFileCmd->SetGuidance("to this phase-space file. An empty name stops recording.");
+  fRecordFileCmd->SetParameterName("fileName",true);
+  fRecordFileCmd->SetDefaultValue("");
+  fRecordFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRecordPlaneCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/record/plane",this);
+  fRecordPlaneCmd->SetGuidance("z of the recording plane. The first foil stack starts at z = 5 cm.");
+  fRecordPlaneCmd->SetParameterName("z",false);
+  fRecordPlaneCmd->SetUnitCategory("Length");
+  fRecordPlaneCmd->SetDefaultUnit("cm");
+  fRecordPlaneCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRecordStopTracksCmd = new G4UIcmdWithABool("/AEgIS/record/stopTracks",this);
+  fRecordStopTracksCmd->SetGuidance("Stop the antiprotons once they are recorded (default true).");
+  fRecordStopTracksCmd->SetParameterName("stop",false);
+  fRecordStopTracksCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRandomDirectory = new G4UIdirectory("/AEgIS/random/");
+  fRandomDirectory->SetGuidance("Reproducible seeding of the events");
+
+  fMasterSeedCmd = new G4UIcmdWithAnInteger("/AEgIS/random/seed",this);
+  fMasterSeedCmd->SetGuidance("Master seed of the simulation. Each event is then seeded");
+  fMasterSeedCmd->SetGuidance("from (seed, jobID, run, event), independently of the threads,");
+  fMasterSeedCmd->SetGuidance("and the seeds are stored in the fRunSummary ntuple.");
+  fMasterSeedCmd->SetParameterName("masterSeed",false);
+  fMasterSeedCmd->SetRange("masterSeed>=0");
+  fMasterSeedCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  // B2RandomSeeder is shared by all threads, only the master sets it
+  fMasterSeedCmd->SetToBeBroadcasted(false);
+
+  fJobIDCmd = new G4UIcmdWithAnInteger("/AEgIS/random/jobID",this);
+  fJobIDCmd->SetGuidance("Index of the job, gives independent events to the jobs");
+  fJobIDCmd->SetGuidance("of a batch submission sharing the same master seed.");
+  fJobIDCmd->SetParameterName("id",false);
+  fJobIDCmd->SetDefaultValue(0);
+  fJobIDCmd->SetRange("id>=0");
+  fJobIDCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fJobIDCmd->SetToBeBroadcasted(false);
+
+  fProfileDirectory = new G4UIdirectory("/AEgIS/profile/");
+  fProfileDirectory->SetGuidance("Per-event wall time and step count");
+
+  fSlowEventTimeCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/profile/slowEventTime",this);
+  fSlowEventTimeCmd->SetGuidance("Log the events taking longer than this wall time");
+  fSlowEventTimeCmd->SetGuidance("to /AEgIS/profile/slowEventFile. 0 disables it.");
+  fSlowEventTimeCmd->SetParameterName("time",false);
+  fSlowEventTimeCmd->SetRange("time>=0.");
+  fSlowEventTimeCmd->SetUnitCategory("Time");
+  fSlowEventTimeCmd->SetDefaultUnit("s");
+  fSlowEventTimeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSlowEventStepsCmd = new G4UIcmdWithAnInteger("/AEgIS/profile/slowEventSteps",this);
+  fSlowEventStepsCmd->SetGuidance("Log the events with at least this number of steps");
+  fSlowEventStepsCmd->SetGuidance("to /AEgIS/profile/slowEventFile. 0 disables it.");
+  fSlowEventStepsCmd->SetParameterName("nSteps",false);
+  fSlowEventStepsCmd->SetRange("nSteps>=0");
+  fSlowEventStepsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSlowEventFileCmd = new G4UIcmdWithAString("/AEgIS/profile/slowEventFile",this);
+  fSlowEventFileCmd->SetGuidance("File the slow events are appended to (slow_events.txt).");
+  fSlowEventFileCmd->SetParameterName("fileName",false);
+  fSlowEventFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fReplayCmd = new G4UIcommand("/AEgIS/replay",this);
+  fReplayCmd->SetGuidance("Rerun one event of a slow event file alone, with the seeds");
+  fReplayCmd->SetGuidance("it had in the original run (requires /AEgIS/random/seed in");
+  fReplayCmd->SetGuidance("that run). Use trackingVerbose 0 to run it under a profiler.");
+  fReplayCmd->SetGuidance("The phase-space file beam (/AEgIS/beam/mode file) is not replayed.");
+  fReplayCmd->SetGuidance("The event is written to replay_job<j>_run<r>_event<e>, the seeds and");
+  fReplayCmd->SetGuidance("output of the following runs are unchanged.");
+  G4UIparameter* logFilePrm = new G4UIparameter("file",'s',false);
+  fReplayCmd->SetParameter(logFilePrm);
+  G4UIparameter* jobPrm = new G4UIparameter("jobID",'i',false);
+  jobPrm->SetParameterRange("jobID>=0");
+  fReplayCmd->SetParameter(jobPrm);
+  G4UIparameter* runPrm = new G4UIparameter("runID",'i',false);
+  runPrm->SetParameterRange("runID>=0");
+  fReplayCmd->SetParameter(runPrm);
+  G4UIparameter* eventPrm = new G4UIparameter("eventID",'i',false);
+  eventPrm->SetParameterRange("eventID>=0");
+  fReplayCmd->SetParameter(eventPrm);
+  G4UIparameter* verbosePrm = new G4UIparameter("trackingVerbose",'i',true);
+  verbosePrm->SetDefaultValue(1);
+  fReplayCmd->SetParameter(verbosePrm);
+  fReplayCmd->AvailableForStates(G4State_Idle);
+  // the master starts the run itself
+  fReplayCmd->SetToBeBroadcasted(false);
+
+  fCheckpointDirectory = new G4UIdirectory("/AEgIS/checkpoint/");
+  fCheckpointDirectory->SetGuidance("Long runs split in chunks that survive a restart of the job");
+
+  fCheckpointFileCmd = new G4UIcmdWithAString("/AEgIS/checkpoint/file",this);
+  fCheckpointFileCmd->SetGuidance("State of /AEgIS/checkpoint/beamOn, written after each chunk");
+  fCheckpointFileCmd->SetGuidance("(the random engine state goes to the same name + .rng).");
+  fCheckpointFileCmd->SetParameterName("fileName",true);
+  fCheckpointFileCmd->SetDefaultValue("");
+  fCheckpointFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCheckpointEventsCmd = new G4UIcmdWithAnInteger("/AEgIS/checkpoint/events",this);
+  fCheckpointEventsCmd->SetGuidance("Events per chunk, each chunk is written to its own");
+  fCheckpointEventsCmd->SetGuidance("output file (_part<n>) before the checkpoint is updated.");
+  fCheckpointEventsCmd->SetParameterName("nEvents",false);
+  fCheckpointEventsCmd->SetRange("nEvents>0");
+  fCheckpointEventsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fResumeCmd = new G4UIcmdWithABool("/AEgIS/checkpoint/resume",this);
+  fResumeCmd->SetGuidance("Continue /AEgIS/checkpoint/beamOn from the last finished chunk");
+  fResumeCmd->SetGuidance("of the checkpoint file instead of starting again.");
+  fResumeCmd->SetParameterName("resume",true);
+  fResumeCmd->SetDefaultValue(true);
+  fResumeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCheckpointBeamOnCmd = new G4UIcmdWithAnInteger("/AEgIS/checkpoint/beamOn",this);
+  fCheckpointBeamOnCmd->SetGuidance("Run the events in chunks of /AEgIS/checkpoint/events,");
+  fCheckpointBeamOnCmd->SetGuidance("writing the checkpoint file after each of them.");
+  fCheckpointBeamOnCmd->SetParameterName("nEvents",false);
+  fCheckpointBeamOnCmd->SetRange("nEvents>0");
+  fCheckpointBeamOnCmd->AvailableForStates(G4State_Idle);
+  // the master starts the runs itself
+  fCheckpointBeamOnCmd->SetToBeBroadcasted(false);
+
+  fPairedBeamOnCmd = new G4UIcmdWithAnInteger("/AEgIS/run/pairedBeamOn",this);
+  fPairedBeamOnCmd->SetGuidance("Run the events with the field on, then the same events");
+  fPairedBeamOnCmd->SetGuidance("(same beam, common random numbers) with the field off.");
+  fPairedBeamOnCmd->SetGuidance("Each run has its own output file (%field% in /AEgIS/output/file,");
+  fPairedBeamOnCmd->SetGuidance("or _fieldon/_fieldoff appended), the events are paired by eventID.");
+  fPairedBeamOnCmd->SetParameterName("nEvents",false);
+  fPairedBeamOnCmd->SetRange("nEvents>0");
+  fPairedBeamOnCmd->AvailableForStates(G4State_Idle);
+  fPairedBeamOnCmd->SetToBeBroadcasted(false);
+
+  fPhysicsDirectory = new G4UIdirectory("/AEgIS/physics/");
+  fPhysicsDirectory->SetGuidance("Physics tables and energy-loss checks");
+
+  fTableCacheCmd = new G4UIcmdWithAString("/AEgIS/physics/tableCache",this);
+  fTableCacheCmd->SetGuidance("Directory where the built physics tables are kept, keyed by");
+  fTableCacheCmd->SetGuidance("a hash of the materials, cuts and physics list. Cached tables");
+  fTableCacheCmd->SetGuidance("are retrieved instead of built, new ones are stored by the first run.");
+  fTableCacheCmd->SetParameterName("directory",false);
+  fTableCacheCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  // the master builds the tables, the workers share them
+  fTableCacheCmd->SetToBeBroadcasted(false);
+
+  fPrintStoppingPowerCmd = new G4UIcmdWithoutParameter("/AEgIS/physics/printStoppingPower",this);
+  fPrintStoppingPowerCmd->SetGuidance("Print the antiproton stopping power and range tables used by");
+  fPrintStoppingPowerCmd->SetGuidance("/AEgIS/physics/rangeKill next to G4EmCalculator for all materials.");
+  fPrintStoppingPowerCmd->AvailableForStates(G4State_Idle);
+  fPrintStoppingPowerCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2RunMessenger::~B2RunMessenger()
+{
+  delete fOutputModeCmd;
+  delete fOutputFileCmd;
+  delete fScratchDirCmd;
+  delete fTrapWindowCmd;
+  delete fOutputDirectory;
+  delete fPrecisionCmd;
+  delete fPrecisionWindowCmd;
+  delete fTimeBudgetCmd;
+  delete fBatchSizeCmd;
+  delete fScoreDirectory;
+  delete fRunDirectory;
+  delete fRecordFileCmd;
+  delete fRecordPlaneCmd;
+  delete fRecordStopTracksCmd;
+  delete fRecordDirectory;
+  delete fMasterSeedCmd;
+  delete fJobIDCmd;
+  delete fRandomDirectory;
+  delete fSlowEventTimeCmd;
+  delete fSlowEventStepsCmd;
+  delete fSlowEventFileCmd;
+  delete fReplayCmd;
+  delete fProfileDirectory;
+  delete fCheckpointFileCmd;
+  delete fCheckpointEventsCmd;
+  delete fResumeCmd;
+  delete fCheckpointBeamOnCmd;
+  delete fPairedBeamOnCmd;
+  delete fCheckpointDirectory;
+  delete fTableCacheCmd;
+  delete fPrintStoppingPowerCmd;
+  delete fPhysicsDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2RunMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{
+  if( command == fOutputModeCmd )
+   { fRunAction->SetOutputMode(newValue);}
+
+  if( command == fOutputFileCmd )
+   { fRunAction->SetOutputFile(newValue);}
+
+  if( command == fScratchDirCmd )
+   { fRunAction->SetScratchDirectory(newValue);}
+
+  if( command == fTrapWindowCmd ) {
+    G4double maxPz, maxPt;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> maxPz >> maxPt >> unit;
+    G4double unitValue = G4UIcommand::ValueOf(unit);
+    fRunAction->AddTrapWindow(maxPz*unitValue, maxPt*unitValue);
+  }
+
+  if( command == fPrecisionCmd )
+   { fRunAction->SetTargetPrecision(fPrecisionCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fPrecisionWindowCmd )
+   { fRunAction->SetPrecisionWindow(fPrecisionWindowCmd->GetNewIntValue(newValue));}
+
+  if( command == fTimeBudgetCmd )
+   { fRunAction->SetTimeBudget(fTimeBudgetCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fBatchSizeCmd )
+   { fRunAction->SetBatchSize(fBatchSizeCmd->GetNewIntValue(newValue));}
+
+  if( command == fRecordFileCmd )
+   { fRunAction->SetRecordFile(newValue);}
+
+  if( command == fRecordPlaneCmd )
+   { fRunAction->SetRecordPlane(fRecordPlaneCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fRecordStopTracksCmd )
+   { fRunAction->SetRecordStopTracks(fRecordStopTracksCmd->GetNewBoolValue(newValue));}
+
+  if( command == fMasterSeedCmd )
+   { B2RandomSeeder::SetMasterSeed(fMasterSeedCmd->GetNewIntValue(newValue));}
+
+  if( command == fJobIDCmd )
+   { B2RandomSeeder::SetJobID(fJobIDCmd->GetNewIntValue(newValue));}
+
+  if( command == fSlowEventTimeCmd )
+   { fRunAction->SetSlowEventTime(fSlowEventTimeCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fSlowEventStepsCmd )
+   { fRunAction->SetSlowEventSteps(fSlowEventStepsCmd->GetNewIntValue(newValue));}
+
+  if( command == fSlowEventFileCmd )
+   { fRunAction->SetSlowEventFile(newValue);}
+
+  if( command == fReplayCmd ) {
+    G4String logFile;
+    G4long jobID;
+    G4int runID, eventID, verbose;
+    std::istringstream is(newValue);
+    is >> logFile >> jobID >> runID >> eventID >> verbose;
+    fRunAction->ReplayEvent(logFile, jobID, runID, eventID, verbose);
+  }
+
+  if( command == fCheckpointFileCmd )
+   { fRunAction->SetCheckpointFile(newValue);}
+
+  if( command == fCheckpointEventsCmd )
+   { fRunAction->SetCheckpointEvents(fCheckpointEventsCmd->GetNewIntValue(newValue));}
+
+  if( command == fResumeCmd )
+   { fRunAction->SetResume(fResumeCmd->GetNewBoolValue(newValue));}
+
+  if( command == fCheckpointBeamOnCmd )
+   { fRunAction->BeamOnCheckpointed(fCheckpointBeamOnCmd->GetNewIntValue(newValue));}
+
+  if( command == fPairedBeamOnCmd )
+   { fRunAction->BeamOnPaired(fPairedBeamOnCmd->GetNewIntValue(newValue));}
+
+  if( command == fTableCacheCmd )
+   { B2PhysicsTableCache::SetDirectory(newValue);}
+
+  if( command == fPrintStoppingPowerCmd ) {
+    B2EnergyLossTable* table = B2EnergyLossTable::Instance();
+    table->Build(G4AntiProton::Definition());
+    table->Validate();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,11 +28,17 @@
 /// \brief Implementation of the B2SteppingAction class
 
 #include "B2SteppingAction.hh"
+#include "B2SteppingMessenger.hh"
 #include "B2EventAction.hh"
 #include "B2bDetectorConstruction.hh"
 #include "B2MagneticField.hh"
+#include "B2PhaseSpaceWriter.hh"
+#include "B2EnergyLossTable.hh"
 
 #include "G4Tubs.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4AntiProton.hh"
 #include "G4Step.hh"    //  from track/src
 #include "G4SteppingVerbose.hh"
 #include "G4SteppingManager.hh"
@@ -40,10 +46,13 @@
 #include "G4VParticleChange.hh"
 #include "G4StepStatus.hh"    // Include from 'tracking'
 #include "G4Event.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
 #include "G4RunManager.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Material.hh"
 #include "G4UnitsTable.hh"
+#include "Randomize.hh"
 class G4VProcess;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -52,17 +61,30 @@ B2SteppingAction::B2SteppingAction(B2EventAction* eventAction)
 : G4UserSteppingAction(),
   fEventAction(eventAction),
   fScoringVolume(0),
-  fStuckSteps(0)
-{}
+  fStuckSteps(0),
+  fSplitVolume("SecondDegrader"),
+  fSplitFactor(1),
+  fSplitMaxEnergy(0.),
+  fRouletteMinPz(0.),
+  fRouletteMinRadius(0.),
+  fRouletteSurvival(1.),
+  fRangeKill(false)
+{
+  fMessenger = new B2SteppingMessenger(this);
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-B2SteppingAction::~B2SteppingAction() {}
+B2SteppingAction::~B2SteppingAction()
+{
+  delete fMessenger;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void B2SteppingAction::UserSteppingAction(const G4Step* step)
 {
+  fEventAction->AddStep();
   
   G4Track* track = step->GetTrack();
   G4ParticleDefinition* particleType = track->GetDefinition();
@@ -91,20 +113,59 @@ void B2SteppingAction::UserSteppingAction(const G4Step* step)
   G4ThreeVector postDirection = step->GetPostStepPoint()->GetMomentumDirection();
   G4ThreeVector postPosition = step->GetPostStepPoint()->GetPosition();
 
+  // two-stage mode: record the primaries crossing the recording plane.
+  // There is no boundary at the plane, the step in the field volume can
+  // end up to maxFieldStep behind it. The crossing is interpolated
+  // linearly between the pre- and post-step points, which follows the
+  // chord of the step (within the miss distance of the chord finder).
+  B2PhaseSpaceWriter* phaseSpaceWriter = B2PhaseSpaceWriter::Instance();
+  if(phaseSpaceWriter->IsOpen() && track->GetParentID() == 0){
+    G4double recordPlane = fEventAction->GetRunAction()->GetRecordPlane();
+    G4StepPoint* prePoint = step->GetPreStepPoint();
+    G4StepPoint* postPoint = step->GetPostStepPoint();
+    G4ThreeVector prePosition = prePoint->GetPosition();
+    if(prePosition[2] < recordPlane && postPosition[2] >= recordPlane){
+      G4double fraction = (recordPlane - prePosition[2])/(postPosition[2] - prePosition[2]);
+      G4ThreeVector crossing = prePosition + fraction*(postPosition - prePosition);
+      G4ThreeVector momentum = prePoint->GetMomentum()
+                             + fraction*(postPoint->GetMomentum() - prePoint->GetMomentum());
+      G4double time = prePoint->GetGlobalTime()
+                    + fraction*(postPoint->GetGlobalTime() - prePoint->GetGlobalTime());
+      B2PhaseSpaceRecord record;
+      record.x = crossing[0]/CLHEP::mm;
+      record.y = crossing[1]/CLHEP::mm;
+      record.z = recordPlane/CLHEP::mm;
+      record.px = momentum[0]/CLHEP::MeV;
+      record.py = momentum[1]/CLHEP::MeV;
+      record.pz = momentum[2]/CLHEP::MeV;
+      record.t = time/CLHEP::ns;
+      record.weight = step->GetPostStepPoint()->GetWeight();
+      phaseSpaceWriter->Write(record);
+      if(fEventAction->GetRunAction()->GetRecordStopTracks()){
+        track->SetTrackStatus(fStopAndKill);
+        return;
+      }
+    }
+  }
+
   G4VPhysicalVolume* ph_volume = step->GetPreStepPoint()->GetPhysicalVolume();
   G4VPhysicalVolume* post_ph_volume = step->GetPostStepPoint()->GetPhysicalVolume();
   // Check if antiproton is moving in oposite direction
   
-  if(direction[2] < 0 && ( post_ph_volume->GetName() == "MagneticField" || post_ph_volume->GetName() == "World" ) ){
+  // the envelopes around the foils are part of the magnetic volume
+  if(direction[2] < 0 && ( post_ph_volume->GetName() == "MagneticField" || post_ph_volume->GetName() == "StackEnvelope"
+                           || post_ph_volume->GetName() == "World" ) ){
     // G4cerr << "Antiproton moving backwards at ("<<position[0] <<","<<position[1]<<","<<position[2]<<") -> stop it" <<G4endl;
-    if( ph_volume->GetName() == "MagneticField" || ph_volume->GetName() == "World" ) fEventAction->IsKilledEvent();
-    // fEventAction->IsKilledEvent();
+    if( ph_volume->GetName() == "MagneticField" || ph_volume->GetName() == "StackEnvelope"
+        || ph_volume->GetName() == "World" ) fEventAction->AddKilledTrack(track->GetWeight());
     track->SetTrackStatus(fStopAndKill);
     return;
   }
   
   // check if the momentum direction is not perpendicular to the BField
   // G4cout << preDirection << " " << step->GetPreStepPoint()->GetPosition()<<G4endl;
+  // the count belongs to the current track, a new one starts from zero
+  if(track->GetCurrentStepNumber() == 1) fStuckSteps = 0;
   if(direction[2] < 1e-6 && abs(postPosition[2] - position[2]) < 0.1 * CLHEP::nm){
     fStuckSteps += 1;
     // Antiproton is moving perpendicular to the BField.
@@ -113,17 +174,43 @@ void B2SteppingAction::UserSteppingAction(const G4Step* step)
     if( fStuckSteps > 50){
       // G4cerr << "Antiproton moving in circles (for "<< fStuckSteps << " steps)-> stop it" <<G4endl;
       track->SetTrackStatus(fStopAndKill);
-      fEventAction->IsKilledEvent();
+      fEventAction->AddKilledTrack(track->GetWeight());
       return;
     }
   }else{
     fStuckSteps=0;
   }
 
+  // the antiproton will stop and annihilate in this volume anyway
+  if(fRangeKill && track->GetTrackStatus() == fAlive && StopsInVolume(step)){
+    track->SetTrackStatus(fStopAndKill);
+    fEventAction->AddAnnihilatedTrack(track->GetWeight());
+    return;
+  }
+
+  // importance splitting when entering the split volume
+  if(fSplitFactor > 1 && step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary
+     && B2bDetectorConstruction::GetLayerName(step->GetPostStepPoint()) == fSplitVolume
+     && (fSplitMaxEnergy <= 0 || track->GetKineticEnergy() < fSplitMaxEnergy)){
+    SplitTrack(step);
+  }
+
+  // Russian roulette for the antiprotons going forward out of a foil block
+  // into the field drift to the next one, the transport that it saves
+  if(fRouletteSurvival < 1 && step->GetPostStepPoint()->GetStepStatus() == fGeomBoundary
+     && track->GetMomentumDirection().z() > 0
+     && B2bDetectorConstruction::IsDriftExit(B2bDetectorConstruction::GetLayerName(step->GetPreStepPoint()))
+     && step->GetPostStepPoint()->GetPhysicalVolume()
+     && (step->GetPostStepPoint()->GetPhysicalVolume()->GetName() == "MagneticField"
+         || step->GetPostStepPoint()->GetPhysicalVolume()->GetName() == "StackEnvelope")){
+    PlayRoulette(track);
+    if(track->GetTrackStatus() == fStopAndKill) return;
+  }
+
   const G4VProcess* G4ProcessAfter = step->GetPostStepPoint()->GetProcessDefinedStep();
   if ( G4ProcessAfter->GetProcessName().find("CaptureAtRest") != std::string::npos ){
     // G4cout <<  G4ProcessAfter->GetProcessName() << " process taken as annihilation" << G4endl;
-    fEventAction->IsAnnihilationEvent();    
+    fEventAction->AddAnnihilatedTrack(track->GetWeight());    
   }
     
   if(ph_volume->GetName() != "Dump") return;
@@ -134,3 +221,67 @@ void B2SteppingAction::UserSteppingAction(const G4Step* step)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+
+void B2SteppingAction::SplitTrack(const G4Step* step)
+{
+  G4Track* track = step->GetTrack();
+  G4double weight = track->GetWeight()/fSplitFactor;
+  track->SetWeight(weight);
+
+  // the copies start from the boundary with the same state as the track,
+  // they are tracked independently afterwards
+  G4TrackVector* secondaries = const_cast<G4Step*>(step)->GetfSecondary();
+  for(G4int i = 1; i < fSplitFactor; i++){
+    G4DynamicParticle* particle = new G4DynamicParticle(track->GetDefinition(),
+                                                        track->GetMomentumDirection(),
+                                                        track->GetKineticEnergy());
+    G4Track* copy = new G4Track(particle, track->GetGlobalTime(), track->GetPosition());
+    copy->SetWeight(weight);
+    copy->SetParentID(track->GetTrackID());
+    copy->SetTouchableHandle(track->GetTouchableHandle());
+    secondaries->push_back(copy);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2SteppingAction::PlayRoulette(G4Track* track)
+{
+  // same momentum convention as B2TrackerSD: Ekin x direction
+  G4double pz = track->GetKineticEnergy()*track->GetMomentumDirection().z();
+  G4double radius = track->GetPosition().perp();
+
+  // no condition set means no antiproton is outside the window of interest
+  G4bool highPz = fRouletteMinPz > 0 && pz > fRouletteMinPz;
+  G4bool largeRadius = fRouletteMinRadius > 0 && radius > fRouletteMinRadius;
+  if(!highPz && !largeRadius) return;
+
+  // killed with probability 1-p, the survivors carry the weight of the killed ones
+  if(G4UniformRand() < fRouletteSurvival) track->SetWeight(track->GetWeight()/fRouletteSurvival);
+  else track->SetTrackStatus(fStopAndKill);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool B2SteppingAction::StopsInVolume(const G4Step* step)
+{
+  const G4Track* track = step->GetTrack();
+  B2EnergyLossTable* table = B2EnergyLossTable::Instance();
+  // rebuilt when the materials change between runs
+  if(!table->IsValid()) table->Build(G4AntiProton::Definition());
+  if(track->GetKineticEnergy() >= table->GetMaxEnergy()) return false;
+
+  // 20% above the CSDA range covers the range straggling; the safety is
+  // at most the shortest distance to the surface of the volume, the path
+  // of the antiproton to any exit is longer
+  G4double range = 1.2*table->GetRange(track->GetMaterial(), track->GetKineticEnergy());
+  if(range < step->GetPostStepPoint()->GetSafety()) return true;
+  // the safety left by the transportation underestimates, ask the navigator:
+  // it computes it for the current copy of a parameterised foil, whose shared
+  // solid may still have the dimensions of a neighbouring copy
+  G4Navigator* navigator
+    = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+  return range < navigator->ComputeSafety(track->GetPosition(), DBL_MAX, true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
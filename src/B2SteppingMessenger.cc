@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2SteppingMessenger.cc
+/// \brief Implementation of the B2SteppingMessenger class
+
+#include "B2SteppingMessenger.hh"
+#include "B2SteppingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2SteppingMessenger::B2SteppingMessenger(B2SteppingAction* steppingAction)
+ : G4UImessenger(),
+   fSteppingAction(steppingAction)
+{
+  fBiasDirectory = new G4UIdirectory("/AEgIS/bias/");
+  fBiasDirectory->SetGuidance("Variance reduction, the output and the trap windows are weighted");
+
+  fSplitVolumeCmd = new G4UIcmdWithAString("/AEgIS/bias/splitVolume",this);
+  fSplitVolumeCmd->SetGuidance("Antiprotons entering this physical volume are split: FirstMetalization,");
+  fSplitVolumeCmd->SetGuidance("FirstDegrader, SecondDegrader, SecondMetalization or a /AEgIS/stack/ layer.");
+  fSplitVolumeCmd->SetParameterName("volume",false);
+  fSplitVolumeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSplitFactorCmd = new G4UIcmdWithAnInteger("/AEgIS/bias/splitFactor",this);
+  fSplitFactorCmd->SetGuidance("Each antiproton entering the split volume continues as n");
+  fSplitFactorCmd->SetGuidance("copies with 1/n of its weight. 1 switches splitting off.");
+  fSplitFactorCmd->SetParameterName("n",false);
+  fSplitFactorCmd->SetRange("n>=1");
+  fSplitFactorCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSplitMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/bias/splitMaxEnergy",this);
+  fSplitMaxEnergyCmd->SetGuidance("Only split antiprotons entering with less kinetic energy,");
+  fSplitMaxEnergyCmd->SetGuidance("i.e. the ones likely to leave the foils trappable. 0 = all.");
+  fSplitMaxEnergyCmd->SetParameterName("energy",false);
+  fSplitMaxEnergyCmd->SetRange("energy>=0.");
+  fSplitMaxEnergyCmd->SetUnitCategory("Energy");
+  fSplitMaxEnergyCmd->SetDefaultUnit("keV");
+  fSplitMaxEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRouletteMinPzCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/bias/rouletteMinPz",this);
+  fRouletteMinPzCmd->SetGuidance("Antiprotons going forward out of a foil block into the field");
+  fRouletteMinPzCmd->SetGuidance("drift to the next one with pz (Ekin x direction) above this");
+  fRouletteMinPzCmd->SetGuidance("value play Russian roulette. 0 = no pz condition.");
+  fRouletteMinPzCmd->SetParameterName("pz",false);
+  fRouletteMinPzCmd->SetRange("pz>=0.");
+  fRouletteMinPzCmd->SetUnitCategory("Energy");
+  fRouletteMinPzCmd->SetDefaultUnit("keV");
+  fRouletteMinPzCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRouletteMinRadiusCmd = new G4UIcmdWithADoubleAndUnit("/AEgIS/bias/rouletteMinRadius",this);
+  fRouletteMinRadiusCmd->SetGuidance("Antiprotons going forward out of a foil block into the field");
+  fRouletteMinRadiusCmd->SetGuidance("drift to the next one further from the axis than this value");
+  fRouletteMinRadiusCmd->SetGuidance("play Russian roulette. 0 = no radius condition.");
+  fRouletteMinRadiusCmd->SetParameterName("radius",false);
+  fRouletteMinRadiusCmd->SetRange("radius>=0.");
+  fRouletteMinRadiusCmd->SetUnitCategory("Length");
+  fRouletteMinRadiusCmd->SetDefaultUnit("mm");
+  fRouletteMinRadiusCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRouletteSurvivalCmd = new G4UIcmdWithADouble("/AEgIS/bias/rouletteSurvival",this);
+  fRouletteSurvivalCmd->SetGuidance("Survival probability p of the Russian roulette, the");
+  fRouletteSurvivalCmd->SetGuidance("survivors get their weight divided by p. 1 = no roulette.");
+  fRouletteSurvivalCmd->SetParameterName("p",false);
+  fRouletteSurvivalCmd->SetRange("p>0. && p<=1.");
+  fRouletteSurvivalCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRangeKillCmd = new G4UIcmdWithABool("/AEgIS/physics/rangeKill",this);
+  fRangeKillCmd->SetGuidance("Count as annihilated, and stop tracking, the antiprotons below");
+  fRangeKillCmd->SetGuidance("200 keV whose range (+20%) is shorter than the distance to any");
+  fRangeKillCmd->SetGuidance("boundary of their volume. Default false.");
+  fRangeKillCmd->SetParameterName("state",true);
+  fRangeKillCmd->SetDefaultValue(true);
+  fRangeKillCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2SteppingMessenger::~B2SteppingMessenger()
+{
+  delete fSplitVolumeCmd;
+  delete fSplitFactorCmd;
+  delete fSplitMaxEnergyCmd;
+  delete fRouletteMinPzCmd;
+  delete fRouletteMinRadiusCmd;
+  delete fRouletteSurvivalCmd;
+  delete fRangeKillCmd;
+  delete fBiasDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2SteppingMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{
+  if( command == fSplitVolumeCmd )
+   { fSteppingAction->SetSplitVolume(newValue);}
+
+  if( command == fSplitFactorCmd )
+   { fSteppingAction->SetSplitFactor(fSplitFactorCmd->GetNewIntValue(newValue));}
+
+  if( command == fSplitMaxEnergyCmd )
+   { fSteppingAction->SetSplitMaxEnergy(fSplitMaxEnergyCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fRouletteMinPzCmd )
+   { fSteppingAction->SetRouletteMinPz(fRouletteMinPzCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fRouletteMinRadiusCmd )
+   { fSteppingAction->SetRouletteMinRadius(fRouletteMinRadiusCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fRouletteSurvivalCmd )
+   { fSteppingAction->SetRouletteSurvival(fRouletteSurvivalCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fRangeKillCmd )
+   { fSteppingAction->SetRangeKill(fRangeKillCmd->GetNewBoolValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
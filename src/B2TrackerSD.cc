@@ -28,11 +28,16 @@
 /// \brief Implementation of the B2TrackerSD class
 
 #include "B2TrackerSD.hh"
+#include "B2EventAction.hh"
+#include "B2OutputWriter.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
 #include "G4SDManager.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
 #include "G4AnalysisManager.hh"
+#include "G4Threading.hh"
 #include "G4ios.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -89,19 +94,65 @@ G4bool B2TrackerSD::ProcessHits(G4Step* aStep, G4TouchableHistory*)
    G4double eResidual = aStep->GetTrack()->GetKineticEnergy();
 
 //   G4cout << "++ Energy after aStep :" << eResidual << G4endl;
+   G4ThreeVector momentum = momentumDirection*eResidual;
+   G4double px = momentum[0]/CLHEP::keV;
+   G4double py = momentum[1]/CLHEP::keV;
+   G4double pz = momentum[2]/CLHEP::keV;
+   // statistical weight, different from 1 with /AEgIS/bias/ or a weighted beam file
+   G4double weight = aStep->GetTrack()->GetWeight();
+
+   // count trappable antiprotons live for /AEgIS/score/trapWindow
+   B2EventAction* eventAction
+     = static_cast<B2EventAction*>(G4EventManager::GetEventManager()->GetUserEventAction());
+   if(eventAction) eventAction->AddDetectedAntiproton(momentum.z(), momentum.perp(), weight);
+
    auto man = G4AnalysisManager::Instance();
-   //fill in position
-   man->FillNtupleDColumn(1,0,position[0]/CLHEP::mm);
-   man->FillNtupleDColumn(1,1,position[1]/CLHEP::mm);
-   man->FillNtupleDColumn(1,2,position[2]/CLHEP::mm);
-   man->AddNtupleRow(1);
-
-   //fill in momentum
-   man->FillNtupleDColumn(2,0,momentumDirection[0]*eResidual/CLHEP::keV);
-   man->FillNtupleDColumn(2,1,momentumDirection[1]*eResidual/CLHEP::keV);
-   man->FillNtupleDColumn(2,2,momentumDirection[2]*eResidual/CLHEP::keV);
-   man->FillNtupleDColumn(2,3,eResidual/CLHEP::keV);
-   man->AddNtupleRow(2);
+   // ntuples and histograms are switched on/off with /AEgIS/output/mode
+   if(man->GetNtupleActivation(1)){
+     //fill in position
+     man->FillNtupleDColumn(1,0,position[0]/CLHEP::mm);
+     man->FillNtupleDColumn(1,1,position[1]/CLHEP::mm);
+     man->FillNtupleDColumn(1,2,position[2]/CLHEP::mm);
+     man->AddNtupleRow(1);
+
+     //fill in momentum
+     man->FillNtupleDColumn(2,0,px);
+     man->FillNtupleDColumn(2,1,py);
+     man->FillNtupleDColumn(2,2,pz);
+     man->FillNtupleDColumn(2,3,eResidual/CLHEP::keV);
+     man->FillNtupleDColumn(2,4,weight);
+     man->FillNtupleIColumn(2,5,G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID());
+     man->AddNtupleRow(2);
+   }
+
+   // stream mode: the record is written by the B2OutputWriter thread
+   B2OutputWriter* writer = B2OutputWriter::Instance();
+   if(writer->IsOpen()){
+     B2HitRecord record;
+     record.eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+     record.threadID = G4Threading::G4GetThreadId();
+     record.x = position[0]/CLHEP::mm;
+     record.y = position[1]/CLHEP::mm;
+     record.z = position[2]/CLHEP::mm;
+     record.px = px;
+     record.py = py;
+     record.pz = pz;
+     record.kineticEnergy = eResidual/CLHEP::keV;
+     record.weight = weight;
+     writer->Push(record);
+   }
+
+   if(man->GetH1Activation(1)){
+     G4double pt = std::sqrt(px*px + py*py);
+     man->FillH1(1,pz,weight);
+     man->FillH1(2,pt,weight);
+     man->FillH1(3,eResidual/CLHEP::keV,weight);
+     man->FillH1(4,position.perp()/CLHEP::mm,weight);
+     man->FillH2(1,pt,pz,weight);
+     // same pT cut as the trap window counts of AddDetectedAntiproton
+     if(eventAction && momentum.perp() <= eventAction->GetRunAction()->GetTrappableMaxPt())
+       man->FillH1(5,pz,weight);
+   }
 
    aStep->GetTrack()->SetTrackStatus(fStopAndKill);
   
@@ -31,7 +31,10 @@
 #include "B2MagneticField.hh"
 #include "B2bDetectorMessenger.hh"
 #include "B2bChamberParameterisation.hh"
+#include "B2bFoilParameterisation.hh"
 #include "B2TrackerSD.hh"
+#include "B2PhysicsTableCache.hh"
+#include "B2NavigationBenchmark.hh"
 
 // BBBBBBBBBBBBBBBBBBb
 #include "G4FieldManager.hh"
@@ -56,6 +59,8 @@
 #include "G4GeometryManager.hh"
 
 #include "G4UserLimits.hh"
+#include "G4StepPoint.hh"
+#include "G4VTouchable.hh"
 
 // BBBBBBBBBBBBBBBBBBBBBB
 #include "G4SDManager.hh"
@@ -69,12 +74,18 @@
 
 #include "G4SystemOfUnits.hh"
 
+#include <set>
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 // BBBBBBBBBBBBBBBBBBBBBB
 //*G4ThreadLocal G4GlobalMagFieldMessenger* B2bDetectorConstruction::fMagFieldMessenger = 0;
 G4ThreadLocal B2MagneticField* B2bDetectorConstruction::fMagneticField = 0;
 G4ThreadLocal G4FieldManager* B2bDetectorConstruction::fFieldMgr = 0;
+std::atomic<G4int> B2bDetectorConstruction::fGeometryVersion(0);
+std::set<G4String> B2bDetectorConstruction::fDriftExitLayers;
+std::map<const G4VPhysicalVolume*, std::vector<G4String> > B2bDetectorConstruction::fGroupLayerNames;
 // BBBBBBBBBBBBBBBBBBBBBB
 
 
@@ -86,7 +97,8 @@ B2bDetectorConstruction::B2bDetectorConstruction():
   fDumpLV(NULL),fDetectorLV(NULL),fMagneticLV(NULL),
   fFirstDegraderMaterial(NULL),fFirstMetalizationMaterial(NULL),
   fSecondDegraderMaterial(NULL),fSecondMetalizationMaterial(NULL),
-  fCheckOverlaps(true)
+  fValidation(false),
+  fOverlapPoints(1000)
 {
   fMessenger = new B2bDetectorMessenger(this);
   fFirstDegraderThickness = 100 * nm;
@@ -95,6 +107,11 @@ B2bDetectorConstruction::B2bDetectorConstruction():
   fFirstMetalizationThickness = 10 * nm;
   fSecondMetalizationThickness = 10 * nm;
 
+  fUseEnvelopes = true;
+  fSmartless = 2.; // Geant4 default
+  fStackMotherLV = NULL;
+  fStackMotherZ = 0.;
+  fWorldPV = NULL;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -140,8 +157,22 @@ void B2bDetectorConstruction::DefineMaterials()
 
   fDumpMaterial = nistManager->FindOrBuildMaterial("G4_Galactic");
 
-  // Print materials
-  G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  // materials of the /AEgIS/stack/ layers
+  for(auto& layer : fLayers){
+    layer.material = SetMaterial(NULL, layer.materialName);
+    if(!layer.material){
+      G4Exception("B2bDetectorConstruction::DefineMaterials()",
+                  "InvalidSetup", FatalException,
+                  ("Unknown material " + layer.materialName + " of layer " + layer.name).c_str());
+    }
+  }
+
+  // Print materials, in validation mode only: the table is printed at
+  // every point of a thickness scan
+  if(fValidation) G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+
+  // the material table is part of the key of the cached physics tables
+  B2PhysicsTableCache::Prepare();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -215,7 +246,7 @@ G4VPhysicalVolume* B2bDetectorConstruction::DefineVolumes()
 			       0,               // its mother  volume
 			       false,           // no boolean operations
 			       0,               // copy number
-			       fCheckOverlaps); // checking overlaps
+			       false); // overlaps are checked after the build
   
 
   // *********************************************************
@@ -254,192 +285,69 @@ G4VPhysicalVolume* B2bDetectorConstruction::DefineVolumes()
 				   fWorldLV,        // its mother volume
 				   false,          // no boolean operations
 				   0,              // copy number
-				   fCheckOverlaps); // checking overlaps
+				   false); // overlaps are checked after the build
 
    // set step limit in tube with magnetic field
    fMagneticLV->SetUserLimits(new G4UserLimits(maxFieldStep));
+   fMagneticLV->SetSmartless(fSmartless);
 
   // BBBBBBBBBBBBBBBB
 
-  if(fFirstDegraderThickness > 0){ // only place thin degrader if its thickness is more than 0
-    // this degrader has a metalization layer:
-    // *********************************************************
-    // ===== First degrader metalization layer (downstream) ====
-    // *********************************************************
-
-    // magnetic field starts 250 cm from the center of the experiment
-    // first foil is positioned at 170 cm from the center
-    // so it is 250 - 170 = 80 cm from the beginning of the magnetic field
-    G4ThreeVector positionFirstMetalization = G4ThreeVector(0,0, -magneticLength/2 + 80*cm + fFirstMetalizationThickness/2);
-    G4cout << "Metalization of the first foils is placed at " << positionFirstMetalization << G4endl;
-    
-    fFirstMetalizationS = new G4Tubs("firstMetalization",
-				     0.,
-				     foilRadius,
-				     fFirstMetalizationThickness/2,
-				     0.*deg,
-				     360.*deg);
-    
-    fFirstMetalizationLV = new G4LogicalVolume(fFirstMetalizationS,
-					       fFirstMetalizationMaterial,
-					       "FirstMetalizationLV",
-					       0,
-					       0,
-					       0);
-  
-    fFirstMetalizationPV = new G4PVPlacement(0,                // no rotation
-					     positionFirstMetalization, // at (x,y,z)
-					     fFirstMetalizationLV,   // its logical volume
-					     "FirstMetalization",       // its name
-					     fMagneticLV,   // its mother volume
-					     false,            // no boolean operations
-					     0,                // copy number
-					     fCheckOverlaps);  // checking overlaps 
-
-    // --------------------------------------------------------
-    // tiny steps in the trace lines (made of Au) ...
-    // ---------------------------------------------------------
-    fFirstMetalizationLV->SetUserLimits(new G4UserLimits(maxMetalizationStep));
-    
-    G4cout << "    Metalization of the first foil is " << fFirstMetalizationThickness/nm << " nm of " << fFirstMetalizationMaterial->GetName() << G4endl;
-    
-    // *********************************************************
-    // ============== First degrader foil    ===================
-    // *********************************************************
-
-
-    G4ThreeVector positionFirstDegrader = positionFirstMetalization + G4ThreeVector(0,0, fFirstMetalizationThickness/2 + fFirstDegraderThickness/2);
-    G4cout << "First degrader foil is placed at " << positionFirstDegrader << G4endl;
-
-    fFirstDegraderS = new G4Tubs("firstDegrader",
-				 0.,
-				 foilRadius,
-				 fFirstDegraderThickness/2,
-				 0.*deg,
-				 360.*deg);
-  
-    fFirstDegraderLV = new G4LogicalVolume(fFirstDegraderS,
-					   fFirstDegraderMaterial,
-					   "FirstDegraderLV",
-					   0,
-					   0,
-					   0);
-  
-    fFirstDegraderPV = new G4PVPlacement(0,              // no rotation
-					 positionFirstDegrader,// at (x,y,z)
-					 fFirstDegraderLV,   // its logical volume
-					 "FirstDegrader",       // its name
-					 fMagneticLV, // its mother volume
-					 false,          // no boolean operations
-					 0,              // copy number
-					 fCheckOverlaps); // checking overlaps 
-
-    // --------------------------------------------------
-    // tiny steps in the degrader foil ...
-    // Sets a max step length in the "target" region, with G4StepLimiter, of 50 nm
-    // --------------------------------------------------    
-    fStepLimit = new G4UserLimits(maxFoilStep);
-    fFirstDegraderLV->SetUserLimits(fStepLimit);
-    
-    G4cout << "    First degrader foil is " << fFirstDegraderThickness/nm << " nm of " << fFirstDegraderMaterial->GetName() << G4endl;
-    
-  }else{ // only place thin degrader if its thickness is more than 0
-    fFirstDegraderLV = NULL;
-    fFirstMetalizationLV = NULL;
-  }
-  
-  
   // *********************************************************
-  // Second Degrader foil (in magnetic field)
+  // =================== Foil stack =========================
   // *********************************************************
-  // main degrader is placed 111.9 cm from the center of the experiment
-  // so it is 250 - 111.9 = 138.1 cm from beginning of the magnetic field
-  G4ThreeVector positionSecondDegrader(0,0,-magneticLength/2 + 138.1 * cm + fSecondDegraderThickness/2);
-  // G4threevector positionSecondDegrader = positionFirstDegrader + G4ThreeVector(0,0,fFirstDegraderThickness/2 + foilGap + fSecondDegraderThickness/2);
-  G4cout << "Second degrader foil is placed at " << positionBeamTube + positionSecondDegrader << G4endl;
-  
-  fSecondDegraderS = new G4Tubs("secondDegrader",
-				0.,
-				foilRadius,
-				fSecondDegraderThickness/2,
-				0.*deg,
-				360.*deg);
-  
- fSecondDegraderLV = new G4LogicalVolume(fSecondDegraderS,
-					 fSecondDegraderMaterial,
-					 "SecondDegraderLV",
-					 0,
-					 0,
-					 0);
- 
- fSecondDegraderPV = new G4PVPlacement(0,              // no rotation
-				       positionSecondDegrader, // at (x,y,z)
-				       fSecondDegraderLV,   // its logical volume
-				       "SecondDegrader",       // its name
-				       fMagneticLV, // its mother volume
-				       false,          // no boolean operations
-				       0,              // copy number
-				       fCheckOverlaps); // checking overlaps 
-
-// --------------------------------------------------
-// tiny steps in the degrader foil ...
-// Sets a max step length in the "target" region, with G4StepLimiter, of 50 nm
-// --------------------------------------------------
-
- fStepLimit = new G4UserLimits(maxFoilStep);
- fSecondDegraderLV->SetUserLimits(fStepLimit);
-
- G4cout << "    Second degrader foil is " << fSecondDegraderThickness/nm << " nm of "
-	<< fSecondDegraderMaterial->GetName() << G4endl;
-
-// *********************************************************
-// ======= second degrader metalization layer    ===========
-// *********************************************************
-  
-  G4ThreeVector positionSecondMetalization = positionSecondDegrader + G4ThreeVector(0,0, fSecondDegraderThickness/2 + fSecondMetalizationThickness/2);
-  G4cout << "Metalization of the second foil is placed at " << positionBeamTube+positionSecondMetalization << G4endl;
-
-
-  fSecondMetalizationS = new G4Tubs("secondMetalization",
-				    0.,
-				    foilRadius,
-				    fSecondMetalizationThickness/2,
-				    0.*deg,
-				    360.*deg);
-  
-  fSecondMetalizationLV = new G4LogicalVolume(fSecondMetalizationS,
-					      fSecondMetalizationMaterial,
-					      "SecondMetalizationLV",
-					      0,
-					      0,
-					      0);
-  
-  fSecondMetalizationPV = new G4PVPlacement(0,                // no rotation
-					    positionSecondMetalization, // at (x,y,z)
-					    fSecondMetalizationLV,   // its logical volume
-					    "SecondMetalization",       // its name
-					    fMagneticLV,   // its mother volume
-					    false,            // no boolean operations
-					    0,                // copy number
-					    fCheckOverlaps);  // checking overlaps 
-
-// --------------------------------------------------------
-// tiny steps in the trace lines (made of Au) ...
-// Sets a max step length in the "detector" region, with G4StepLimiter, of 5 nm
-// ---------------------------------------------------------
 
-  fStepLimit = new G4UserLimits(maxMetalizationStep);
-  fSecondMetalizationLV->SetUserLimits(fStepLimit);
+  // layers given with /AEgIS/stack/addLayer, by default the two degrader
+  // foils with their metalization set by the /AEgIS/degrader/ commands
+  std::vector<B2FoilLayer> layers = fLayers;
+  if(layers.empty()){
+    B2FoilLayer layer;
+    layer.radius = foilRadius;
+    if(fFirstDegraderThickness > 0){ // only place thin degrader if its thickness is more than 0
+      // magnetic field starts 250 cm from the center of the experiment
+      // first foil is positioned at 170 cm from the center
+      // so it is 250 - 170 = 80 cm from the beginning of the magnetic field
+      layer.name = "FirstMetalization";
+      layer.material = fFirstMetalizationMaterial;
+      layer.thickness = fFirstMetalizationThickness;
+      layer.z = 80*cm;
+      layer.maxStep = maxMetalizationStep;
+      layers.push_back(layer);
+
+      layer.name = "FirstDegrader";
+      layer.material = fFirstDegraderMaterial;
+      layer.thickness = fFirstDegraderThickness;
+      layer.z = -1;
+      layer.maxStep = maxFoilStep;
+      layers.push_back(layer);
+    }
+    // main degrader is placed 111.9 cm from the center of the experiment
+    // so it is 250 - 111.9 = 138.1 cm from beginning of the magnetic field
+    layer.name = "SecondDegrader";
+    layer.material = fSecondDegraderMaterial;
+    layer.thickness = fSecondDegraderThickness;
+    layer.z = 138.1*cm;
+    layer.maxStep = maxFoilStep;
+    layers.push_back(layer);
+
+    layer.name = "SecondMetalization";
+    layer.material = fSecondMetalizationMaterial;
+    layer.thickness = fSecondMetalizationThickness;
+    layer.z = -1;
+    layer.maxStep = maxMetalizationStep;
+    layers.push_back(layer);
+  }
 
-  G4cout << "    Metalization of the second foil is " << fSecondMetalizationThickness/nm << " nm of " << fSecondMetalizationMaterial->GetName() << G4endl;
-  
+  G4double stackEnd = PlaceLayers(layers, -magneticLength/2, foilRadius);
 
   // *********************************************************
   // ======= DETECTOR   ===========
   // *********************************************************
   
-  G4ThreeVector positionDetector = positionSecondMetalization + G4ThreeVector(0,0, fSecondMetalizationThickness/2 + 2.5*nm);
+  G4ThreeVector positionDetector = G4ThreeVector(0,0, stackEnd + 2.5*nm);
   G4cout << " Detector is placed at " << positionDetector << G4endl;
+  // in the envelope of the last layer
+  positionDetector -= G4ThreeVector(0,0, fStackMotherZ);
 
 
   fDetectorS = new G4Tubs("detectorS",
@@ -460,10 +368,10 @@ G4VPhysicalVolume* B2bDetectorConstruction::DefineVolumes()
 				  positionDetector, // at (x,y,z)
 				  fDetectorLV,   // its logical volume
 				  "Detector",       // its name
-				  fMagneticLV,   // its mother volume
+				  fStackMotherLV,   // its mother volume
 				  false,            // no boolean operations
 				  0,                // copy number
-				  fCheckOverlaps);  // checking overlaps 
+				  false);  // overlaps are checked after the build
 
 // --------------------------------------------------------
 // tiny steps in the trace lines (made of Au) ...
@@ -511,7 +419,7 @@ G4VPhysicalVolume* B2bDetectorConstruction::DefineVolumes()
 			      fWorldLV,   // its mother volume
 			      false,            // no boolean operations
 			      0,                // copy number
-			      fCheckOverlaps);  // checking overlaps 
+			      false);  // overlaps are checked after the build
 
 // --------------------------------------------------------
 // tiny steps in the dump (made of Au) ...
@@ -527,21 +435,6 @@ G4VPhysicalVolume* B2bDetectorConstruction::DefineVolumes()
   G4VisAttributes* worldVisAtt= new G4VisAttributes(G4Colour(1.0,1.0,1.0));
   fWorldLV->SetVisAttributes(worldVisAtt);  
 
-  G4VisAttributes* firstDegraderVis = new G4VisAttributes(G4Colour(0.0,1.0,0.0)); // green
-  firstDegraderVis->SetForceSolid(true);
-  if(fFirstDegraderThickness > 0) fFirstDegraderLV->SetVisAttributes(firstDegraderVis);
-  
-  G4VisAttributes* secondDegraderVis = new G4VisAttributes(G4Colour(0.0,0.0,1.0)); // blue
-  secondDegraderVis->SetForceSolid(true);
-  fSecondDegraderLV->SetVisAttributes(secondDegraderVis);
-
-  G4VisAttributes* metalizationVis = new G4VisAttributes(G4Colour::Gray());
-  if(fFirstDegraderThickness > 0) fSecondMetalizationLV->SetVisAttributes(metalizationVis);
-  fSecondMetalizationLV->SetVisAttributes(metalizationVis);
-  
-  // G4VisAttributes* redDump= new G4VisAttributes(G4Colour(1.0,0.0,0.0));
-  // fDumpLV ->SetVisAttributes(redDump);
-
   G4VisAttributes* magneticVisAtt= new G4VisAttributes(G4Colour(0.9,0.9,0.9,0.2));
   magneticVisAtt->SetForceAuxEdgeVisible(true);
   fMagneticLV->SetVisAttributes(magneticVisAtt);  
@@ -566,11 +459,229 @@ G4VPhysicalVolume* B2bDetectorConstruction::DefineVolumes()
   ///                                           maxTime,
   ///                                           minEkin));
 
+  // --------------------------------------------------
+  // overlaps ...
+  // The thicknesses of a scan only move the faces of the layers, the
+  // overlaps are checked for each new list of volumes (names, explicit
+  // positions, radii), in validation mode at every build
+  // --------------------------------------------------
+  std::ostringstream topology;
+  topology << fUseEnvelopes;
+  for(const auto& layer : layers) topology << " " << layer.name << ":" << layer.z << ":" << layer.radius;
+  if(fValidation || fCheckedTopologies.insert(topology.str()).second) CheckOverlaps(fWorldLV);
+
+  ++fGeometryVersion;
+
   // Always return the physical world
 
   return fWorldPV;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double B2bDetectorConstruction::PlaceLayers(const std::vector<B2FoilLayer>& layers, G4double magneticStart,
+					      G4double detectorRadius)
+{
+  fFirstMetalizationLV = NULL;
+  fFirstDegraderLV = NULL;
+  fSecondDegraderLV = NULL;
+  fSecondMetalizationLV = NULL;
+
+  G4VisAttributes* metalizationVis = new G4VisAttributes(G4Colour::Gray());
+  G4VisAttributes* degraderVis[2] = {new G4VisAttributes(G4Colour(0.0,1.0,0.0)),  // green
+                                     new G4VisAttributes(G4Colour(0.0,0.0,1.0))}; // blue
+  degraderVis[0]->SetForceSolid(true);
+  degraderVis[1]->SetForceSolid(true);
+  G4int nDegraders = 0;
+  fGroupLayerNames.clear();
+  fDriftExitLayers.clear();
+
+  // upstream face of every layer in the magnetic volume
+  std::vector<G4double> layerZ(layers.size());
+  G4double z = magneticStart;
+  for(std::size_t i = 0; i < layers.size(); i++){
+    if(layers[i].z >= 0) z = magneticStart + layers[i].z;
+    layerZ[i] = z;
+    z += layers[i].thickness;
+  }
+
+  // --------------------------------------------------
+  // thin envelopes around the foils ...
+  // Touching layers are placed in a vacuum envelope just larger than them,
+  // so that the steps around the foils are navigated in a volume with a few
+  // daughters instead of in the 150 cm long magnetic volume. Same material,
+  // field and step limit as the magnetic volume, the physics is unchanged.
+  // --------------------------------------------------
+  std::vector<G4LogicalVolume*> motherLV(layers.size(), fMagneticLV);
+  std::vector<G4double> motherZ(layers.size(), 0.);
+  fEnvelopeLVs.clear();
+  fFoilRanges.clear();
+  G4VisAttributes* envelopeVis = new G4VisAttributes();
+  envelopeVis->SetVisibility(false);
+  G4double margin = 1*um; // covers the detector placed behind the last layer
+  std::size_t block = 0;
+  while(block < layers.size()){
+    std::size_t last = block;
+    G4double radius = layers[block].radius;
+    while(last + 1 < layers.size() && layers[last+1].z < 0){
+      last++;
+      radius = std::max(radius, layers[last].radius);
+    }
+    if(last + 1 == layers.size()) radius = std::max(radius, detectorRadius);
+    G4double start = layerZ[block];
+    G4double end = layerZ[last] + layers[last].thickness;
+    fFoilRanges.push_back(std::make_pair(start, end));
+    if(last + 1 < layers.size()) fDriftExitLayers.insert(layers[last].name);
+    if(!fUseEnvelopes){
+      block = last + 1;
+      continue;
+    }
+    // never more than half of the gap to the neighbouring envelopes
+    G4double marginBefore = block == 0 ? margin
+      : std::max(0., std::min(margin, (start - layerZ[block-1] - layers[block-1].thickness)/2));
+    G4double marginAfter = last + 1 == layers.size() ? margin
+      : std::max(0., std::min(margin, (layerZ[last+1] - end)/2));
+    start -= marginBefore;
+    end += marginAfter;
+
+    G4Tubs* envelopeS = new G4Tubs("StackEnvelope",
+				   0.,
+				   radius + margin,
+				   (end - start)/2,
+				   0.*deg,
+				   360.*deg);
+
+    G4LogicalVolume* envelopeLV = new G4LogicalVolume(envelopeS,
+						      fVacuumMaterial,
+						      "StackEnvelopeLV",
+						      0,
+						      0,
+						      0);
+
+    new G4PVPlacement(0,                // no rotation
+		      G4ThreeVector(0,0, (start + end)/2), // at (x,y,z)
+		      envelopeLV,       // its logical volume
+		      "StackEnvelope",  // its name
+		      fMagneticLV,      // its mother volume
+		      false,            // no boolean operations
+		      fEnvelopeLVs.size(), // copy number
+		      false);  // overlaps are checked after the build
+
+    envelopeLV->SetUserLimits(fMagneticLV->GetUserLimits());
+    envelopeLV->SetSmartless(fSmartless);
+    envelopeLV->SetVisAttributes(envelopeVis);
+    fEnvelopeLVs.push_back(envelopeLV);
+
+    for(std::size_t i = block; i <= last; i++){
+      motherLV[i] = envelopeLV;
+      motherZ[i] = (start + end)/2;
+    }
+    block = last + 1;
+  }
+  fStackMotherLV = layers.empty() ? fMagneticLV : motherLV.back();
+  fStackMotherZ = layers.empty() ? 0. : motherZ.back();
+
+  std::size_t first = 0;
+  while(first < layers.size()){
+    // touching layers with the same radius and step limit form one foil
+    std::size_t last = first;
+    while(last + 1 < layers.size() && layers[last+1].z < 0
+          && layers[last+1].radius == layers[first].radius
+          && layers[last+1].maxStep == layers[first].maxStep) last++;
+    std::vector<B2FoilLayer> foil(layers.begin() + first, layers.begin() + last + 1);
+    z = layerZ[first] - motherZ[first]; // in the mother volume
+
+    G4Tubs* foilS = new G4Tubs(layers[first].name,
+			       0.,
+			       layers[first].radius,
+			       layers[first].thickness/2,
+			       0.*deg,
+			       360.*deg);
+
+    G4LogicalVolume* foilLV = new G4LogicalVolume(foilS,
+						  layers[first].material,
+						  layers[first].name + "LV",
+						  0,
+						  0,
+						  0);
+
+    if(foil.size() == 1){
+      new G4PVPlacement(0,                // no rotation
+			G4ThreeVector(0,0, z + layers[first].thickness/2), // at (x,y,z)
+			foilLV,           // its logical volume
+			layers[first].name, // its name
+			motherLV[first],  // its mother volume
+			false,            // no boolean operations
+			0,                // copy number
+			false);  // overlaps are checked after the build
+    }else{
+      // a foil of many layers is one parameterised volume, voxelised along z
+      G4VPhysicalVolume* foilPV
+	= new G4PVParameterised(layers[first].name, // its name
+				foilLV,           // its logical volume
+				motherLV[first],  // its mother volume
+				kZAxis,           // the layers are placed along z
+				foil.size(),      // number of layers
+				new B2bFoilParameterisation(foil, z),
+				false);  // overlaps are checked after the build
+      // the volume has the name of the first layer, the others are known by copy number
+      for(const auto& layer : foil) fGroupLayerNames[foilPV].push_back(layer.name);
+    }
+
+    // --------------------------------------------------
+    // tiny steps in the foil layers ...
+    // Sets a max step length of the layer, with G4StepLimiter
+    // --------------------------------------------------
+    if(layers[first].maxStep > 0){
+      fStepLimit = new G4UserLimits(layers[first].maxStep);
+      foilLV->SetUserLimits(fStepLimit);
+    }
+
+    if(G4StrUtil::contains(layers[first].name, "Metalization")) foilLV->SetVisAttributes(metalizationVis);
+    else foilLV->SetVisAttributes(degraderVis[nDegraders++ % 2]);
+
+    // the /AEgIS/degrader/ material commands change the default layers
+    if(layers[first].name == "FirstMetalization") fFirstMetalizationLV = foilLV;
+    if(layers[first].name == "FirstDegrader") fFirstDegraderLV = foilLV;
+    if(layers[first].name == "SecondDegrader") fSecondDegraderLV = foilLV;
+    if(layers[first].name == "SecondMetalization") fSecondMetalizationLV = foilLV;
+
+    for(std::size_t i = first; i <= last; i++){
+      G4cout << layers[i].name << (foil.size() > 1 ? " (layer " + std::to_string(i - first) + ")" : "")
+	     << " is placed at " << (layerZ[i] - magneticStart)/cm << " cm from the beginning of the magnetic field" << G4endl;
+      G4cout << "    " << layers[i].thickness/nm << " nm of " << layers[i].material->GetName() << G4endl;
+    }
+    first = last + 1;
+  }
+  // the downstream face of the last layer
+  return layers.empty() ? magneticStart : layerZ.back() + layers.back().thickness;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::CheckOverlaps(G4LogicalVolume* motherLV)
+{
+  if(motherLV == fWorldLV) G4cout << "Checking overlaps with " << fOverlapPoints << " points per volume" << G4endl;
+  std::set<G4LogicalVolume*> checked;
+  for(std::size_t i = 0; i < motherLV->GetNoDaughters(); i++){
+    G4VPhysicalVolume* daughter = motherLV->GetDaughter(i);
+    daughter->CheckOverlaps(fOverlapPoints, 0., fValidation);
+    // the daughters of a logical volume placed many times are checked once
+    if(checked.insert(daughter->GetLogicalVolume()).second) CheckOverlaps(daughter->GetLogicalVolume());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String B2bDetectorConstruction::GetLayerName(const G4StepPoint* point)
+{
+  G4VPhysicalVolume* volume = point->GetPhysicalVolume();
+  if(!volume) return "";
+  auto group = fGroupLayerNames.find(volume);
+  if(group == fGroupLayerNames.end()) return volume->GetName();
+  return group->second[point->GetTouchable()->GetReplicaNumber()];
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
  
 void B2bDetectorConstruction::ConstructSDandField()
@@ -578,7 +689,11 @@ void B2bDetectorConstruction::ConstructSDandField()
   // Sensitive detectors
 
   // G4String trackerChamberSDname = "B2/TrackerChamberSD";
-  B2TrackerSD* dumpDetector = new B2TrackerSD("AntiprotonDetector", "AntiprotonHitsCollection");
+  // the geometry is rebuilt for every point of a thickness scan (scan.mac),
+  // the detector and the field are only created the first time
+  G4VSensitiveDetector* dumpDetector
+    = G4SDManager::GetSDMpointer()->FindSensitiveDetector("AntiprotonDetector", false);
+  if(!dumpDetector) dumpDetector = new B2TrackerSD("AntiprotonDetector", "AntiprotonHitsCollection");
   fDetectorLV->SetSensitiveDetector(dumpDetector);
   
   // Create global magnetic field messenger.
@@ -586,10 +701,12 @@ void B2bDetectorConstruction::ConstructSDandField()
   // the field value is not zero.
   
   // magnetic field ----------------------------------------------------------
-  fMagneticField = new B2MagneticField(fMagneticFieldStart);
-  fFieldMgr = new G4FieldManager();
-  fFieldMgr->SetDetectorField(fMagneticField);
-  fFieldMgr->CreateChordFinder(fMagneticField);
+  if(!fFieldMgr){
+    fMagneticField = new B2MagneticField(fMagneticFieldStart);
+    fFieldMgr = new G4FieldManager();
+    fFieldMgr->SetDetectorField(fMagneticField);
+    fFieldMgr->CreateChordFinder(fMagneticField);
+  }
   //
   // associate this field manager with the logical volume (magnetic volume)
   G4bool forceToAllDaughters = true;
@@ -662,6 +779,7 @@ G4Material* B2bDetectorConstruction::SetMaterial(G4LogicalVolume* fGeneralLV, G4
      }
   }
   G4cout<<pttoMaterial<<G4endl;
+  B2PhysicsTableCache::Prepare();
   return pttoMaterial;
 }
 
@@ -695,14 +813,89 @@ void B2bDetectorConstruction::SetSecondMetalizationMaterial(G4String materialNam
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void B2bDetectorConstruction::AddLayer(const B2FoilLayer& layer)
+{
+  fLayers.push_back(layer);
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::ClearLayers()
+{
+  fLayers.clear();
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::SetEnvelopes(G4bool state)
+{
+  fUseEnvelopes = state;
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::SetSmartless(G4double smartless)
+{
+  fSmartless = smartless;
+  // the voxels are rebuilt with the new value when the geometry is closed again
+  if(fMagneticLV) fMagneticLV->SetSmartless(fSmartless);
+  for(auto envelopeLV : fEnvelopeLVs) envelopeLV->SetSmartless(fSmartless);
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::SetValidation(G4bool state)
+{
+  fValidation = state;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::SetOverlapPoints(G4int points)
+{
+  fOverlapPoints = points;
+  // check the current geometry again with the new number of points
+  fCheckedTopologies.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::BenchmarkNavigation(G4int nRays, G4double maxStep)
+{
+  if(!fWorldPV){
+    G4cout << "The geometry is not built yet, run /run/initialize first" << G4endl;
+    return;
+  }
+  // the run closes the geometry, close it here so that the voxels are the ones
+  // the tracking would use
+  G4GeometryManager* geometryManager = G4GeometryManager::GetInstance();
+  geometryManager->OpenGeometry();
+  geometryManager->CloseGeometry(true);
+  B2NavigationBenchmark::Run(fWorldPV, fFoilRanges, nRays, maxStep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void B2bDetectorConstruction::SetMagneticField(G4bool state)
 {
   fBFieldOn = state;
-  if(fMagneticLV){
+  ApplyMagneticField();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bDetectorConstruction::ApplyMagneticField() const
+{
+  // no rebuild needed, the field manager is only switched on the magnetic
+  // volume and all its daughters
+  if(fMagneticLV && fFieldMgr){
     if(fBFieldOn)fMagneticLV->SetFieldManager(fFieldMgr, true);
     else fMagneticLV->SetFieldManager(NULL, true);
   }
-
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
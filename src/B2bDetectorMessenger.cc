@@ -33,6 +33,15 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -101,10 +110,87 @@ B2bDetectorMessenger::B2bDetectorMessenger(B2bDetectorConstruction* Det)
   fSecondMetalizationMaterialCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
   
   fMagneticFieldOnCmd = new G4UIcmdWithAString("/AEgIS/BField",this);
-  fMagneticFieldOnCmd->SetGuidance("Switch on/off magnetic field");
+  fMagneticFieldOnCmd->SetGuidance("Switch on/off magnetic field, also between runs (no rebuild)");
   fMagneticFieldOnCmd->SetParameterName("magneticFieldOn",false);
   fMagneticFieldOnCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  fStackDirectory = new G4UIdirectory("/AEgIS/stack/");
+  fStackDirectory->SetGuidance("Foil stack made of any number of layers, replaces the two");
+  fStackDirectory->SetGuidance("/AEgIS/degrader/ foils once a layer is added. Changes after");
+  fStackDirectory->SetGuidance("/run/initialize need /run/reinitializeGeometry.");
+
+  fAddLayerCmd = new G4UIcommand("/AEgIS/stack/addLayer",this);
+  fAddLayerCmd->SetGuidance("Add a layer downstream of the previous ones. Thickness and maxStep");
+  fAddLayerCmd->SetGuidance("in nm (maxStep 0 = no step limit), z of the upstream face in cm from");
+  fAddLayerCmd->SetGuidance("the beginning of the magnetic field (negative = touching the previous");
+  fAddLayerCmd->SetGuidance("layer), radius in mm.");
+  G4UIparameter* namePrm = new G4UIparameter("name",'s',false);
+  fAddLayerCmd->SetParameter(namePrm);
+  G4UIparameter* materialPrm = new G4UIparameter("material",'s',false);
+  fAddLayerCmd->SetParameter(materialPrm);
+  G4UIparameter* thicknessPrm = new G4UIparameter("thickness",'d',false);
+  thicknessPrm->SetParameterRange("thickness>0.");
+  fAddLayerCmd->SetParameter(thicknessPrm);
+  G4UIparameter* maxStepPrm = new G4UIparameter("maxStep",'d',true);
+  maxStepPrm->SetDefaultValue(0.);
+  maxStepPrm->SetParameterRange("maxStep>=0.");
+  fAddLayerCmd->SetParameter(maxStepPrm);
+  G4UIparameter* zPrm = new G4UIparameter("z",'d',true);
+  zPrm->SetDefaultValue(-1.);
+  fAddLayerCmd->SetParameter(zPrm);
+  G4UIparameter* radiusPrm = new G4UIparameter("radius",'d',true);
+  radiusPrm->SetDefaultValue(15.);
+  radiusPrm->SetParameterRange("radius>0.");
+  fAddLayerCmd->SetParameter(radiusPrm);
+  fAddLayerCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fClearLayersCmd = new G4UIcmdWithoutParameter("/AEgIS/stack/clear",this);
+  fClearLayersCmd->SetGuidance("Remove all the layers, back to the /AEgIS/degrader/ foils.");
+  fClearLayersCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fGeometryDirectory = new G4UIdirectory("/AEgIS/geometry/");
+  fGeometryDirectory->SetGuidance("Navigation settings of the geometry, they do not change the physics.");
+
+  fEnvelopesCmd = new G4UIcmdWithABool("/AEgIS/geometry/envelopes",this);
+  fEnvelopesCmd->SetGuidance("Place the touching layers in a thin vacuum envelope (default true).");
+  fEnvelopesCmd->SetGuidance("Changes after /run/initialize need /run/reinitializeGeometry.");
+  fEnvelopesCmd->SetParameterName("envelopes",false);
+  fEnvelopesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSmartlessCmd = new G4UIcmdWithADouble("/AEgIS/geometry/smartless",this);
+  fSmartlessCmd->SetGuidance("Average number of voxels per daughter in the magnetic volume");
+  fSmartlessCmd->SetGuidance("and in the envelopes (Geant4 default 2).");
+  fSmartlessCmd->SetParameterName("smartless",false);
+  fSmartlessCmd->SetRange("smartless>0.");
+  fSmartlessCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBenchmarkCmd = new G4UIcommand("/AEgIS/geometry/benchmark",this);
+  fBenchmarkCmd->SetGuidance("Time the navigation of straight rays through each foil,");
+  fBenchmarkCmd->SetGuidance("with steps of at most maxStep (nm).");
+  G4UIparameter* nRaysPrm = new G4UIparameter("nRays",'i',true);
+  nRaysPrm->SetDefaultValue(1000);
+  nRaysPrm->SetParameterRange("nRays>0");
+  fBenchmarkCmd->SetParameter(nRaysPrm);
+  G4UIparameter* benchmarkStepPrm = new G4UIparameter("maxStep",'d',true);
+  benchmarkStepPrm->SetDefaultValue(5.);
+  benchmarkStepPrm->SetParameterRange("maxStep>0.");
+  fBenchmarkCmd->SetParameter(benchmarkStepPrm);
+  fBenchmarkCmd->SetToBeBroadcasted(false);
+  fBenchmarkCmd->AvailableForStates(G4State_Idle);
+
+  fValidationCmd = new G4UIcmdWithABool("/AEgIS/geometry/validation",this);
+  fValidationCmd->SetGuidance("Validation mode: check the overlaps and print the material table");
+  fValidationCmd->SetGuidance("at every build of the geometry. Otherwise (production, default) the");
+  fValidationCmd->SetGuidance("overlaps are checked once for each list of volumes, not for every");
+  fValidationCmd->SetGuidance("thickness of a scan, and the material table is not printed.");
+  fValidationCmd->SetParameterName("validation",false);
+  fValidationCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fOverlapPointsCmd = new G4UIcmdWithAnInteger("/AEgIS/geometry/overlapPoints",this);
+  fOverlapPointsCmd->SetGuidance("Number of surface points per volume of the overlap checks (default 1000).");
+  fOverlapPointsCmd->SetParameterName("overlapPoints",false);
+  fOverlapPointsCmd->SetRange("overlapPoints>0");
+  fOverlapPointsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -114,6 +200,15 @@ B2bDetectorMessenger::~B2bDetectorMessenger()
   delete fFirstDegraderThicknessCmd;
   delete fSecondDegraderThicknessCmd;
   delete fStepMaxCmd;
+  delete fAddLayerCmd;
+  delete fClearLayersCmd;
+  delete fStackDirectory;
+  delete fEnvelopesCmd;
+  delete fSmartlessCmd;
+  delete fBenchmarkCmd;
+  delete fValidationCmd;
+  delete fOverlapPointsCmd;
+  delete fGeometryDirectory;
   delete fB2Directory;
   delete fDetDirectory;
 }
@@ -154,6 +249,41 @@ void B2bDetectorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
     if(newValue == "on" || newValue == "On" || newValue =="ON") fDetectorConstruction->SetMagneticField(true);
     else if(newValue == "off" || newValue == "Off" || newValue =="OFF") fDetectorConstruction->SetMagneticField(false);    
   }
+
+  if( command == fAddLayerCmd ) {
+    B2FoilLayer layer;
+    G4double z;
+    std::istringstream is(newValue);
+    is >> layer.name >> layer.materialName >> layer.thickness >> layer.maxStep >> z >> layer.radius;
+    layer.thickness *= nm;
+    layer.maxStep *= nm;
+    layer.z = z < 0 ? -1. : z*cm;
+    layer.radius *= mm;
+    fDetectorConstruction->AddLayer(layer);
+  }
+
+  if( command == fClearLayersCmd )
+   { fDetectorConstruction->ClearLayers();}
+
+  if( command == fEnvelopesCmd )
+   { fDetectorConstruction->SetEnvelopes(fEnvelopesCmd->GetNewBoolValue(newValue));}
+
+  if( command == fSmartlessCmd )
+   { fDetectorConstruction->SetSmartless(fSmartlessCmd->GetNewDoubleValue(newValue));}
+
+  if( command == fBenchmarkCmd ) {
+    G4int nRays;
+    G4double maxStep;
+    std::istringstream is(newValue);
+    is >> nRays >> maxStep;
+    fDetectorConstruction->BenchmarkNavigation(nRays, maxStep*nm);
+  }
+
+  if( command == fValidationCmd )
+   { fDetectorConstruction->SetValidation(fValidationCmd->GetNewBoolValue(newValue));}
+
+  if( command == fOverlapPointsCmd )
+   { fDetectorConstruction->SetOverlapPoints(fOverlapPointsCmd->GetNewIntValue(newValue));}
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+/// \file B2bFoilParameterisation.cc
+/// \brief Implementation of the B2bFoilParameterisation class
+
+#include "B2bFoilParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4ThreeVector.hh"
+#include "G4Tubs.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2bFoilParameterisation::B2bFoilParameterisation(
+        const std::vector<B2FoilLayer>& layers,
+        G4double startZ)          //  Z of the upstream face of the first layer
+ : G4VPVParameterisation()
+{
+   fRadius = layers.empty() ? 0. : layers.front().radius;
+   G4double z = startZ;
+   for(const auto& layer : layers){
+      fCentreZ.push_back(z + 0.5*layer.thickness);
+      fHalfThickness.push_back(0.5*layer.thickness);
+      fMaterials.push_back(layer.material);
+      z += layer.thickness;
+   }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+B2bFoilParameterisation::~B2bFoilParameterisation()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bFoilParameterisation::ComputeTransformation
+(const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+  // Note: copyNo will start with zero!
+  G4ThreeVector origin(0,0,fCentreZ[copyNo]);
+  physVol->SetTranslation(origin);
+  physVol->SetRotation(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void B2bFoilParameterisation::ComputeDimensions
+(G4Tubs& foilLayer, const G4int copyNo, const G4VPhysicalVolume*) const
+{
+  // Note: copyNo will start with zero!
+  foilLayer.SetInnerRadius(0);
+  foilLayer.SetOuterRadius(fRadius);
+  foilLayer.SetZHalfLength(fHalfThickness[copyNo]);
+  foilLayer.SetStartPhiAngle(0.*deg);
+  foilLayer.SetDeltaPhiAngle(360.*deg);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Material* B2bFoilParameterisation::ComputeMaterial
+(const G4int copyNo, G4VPhysicalVolume*, const G4VTouchable*)
+{
+  return fMaterials[copyNo];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......